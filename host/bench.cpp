@@ -0,0 +1,584 @@
+/**
+ * @file bench.cpp
+ * @brief Host-native benchmark harness for the tensile tester firmware
+ *
+ * Replaces main.cpp in the host build: wires the firmware objects to
+ * the simulated hardware (see sim/), runs the machine through a full
+ * startup / homing / test cycle, and times the hot paths:
+ *
+ * - Protocol::processInput() command parse throughput
+ * - Protocol::sendData() packets/sec, ASCII and binary framing
+ * - StateMachine::update() latency while RUNNING (worst case and mean)
+ * - Ramp math steps/sec (alarm callback + computeNewSpeed + pulse)
+ * - Ramp table rebuild time (setAcceleration)
+ *
+ * Timing uses the host's steady clock directly - simulated time only
+ * drives the firmware's own scheduling. Results print as "BENCH" lines
+ * for easy per-commit comparison; the harness exits non-zero if the
+ * machine fails to reach READY/RUNNING, so it doubles as a smoke test
+ * under ctest.
+ */
+
+#include "pico/stdlib.h"
+#include "pico_sim.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+
+#include "Config.h"
+#include "LoadCell.h"
+#include "Stepper.h"
+#include "PulseEngine.h"
+#include "Protocol.h"
+#include "SerialTx.h"
+#include "Capture.h"
+#include "Settings.h"
+#include "StateMachine.h"
+
+// ============================================================================
+// Global Objects (mirrors main.cpp)
+// ============================================================================
+
+LoadCell loadCell(NAU7802_SDA_PIN, NAU7802_SCL_PIN);
+Stepper stepper(STEPPER_STEP_PIN, STEPPER_DIR_PIN, STEPPER_ENABLE_PIN);
+PulseEngine pulseEngine(stepper);
+Protocol protocol;
+Capture capture;
+Settings settings;
+
+StateMachine stateMachine(loadCell, stepper, pulseEngine, protocol, capture, settings);
+
+// Baseline raw ADC counts the NAU7802 model reports at zero load
+static const int32_t BASE_RAW = 500000;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static double elapsedSeconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * @brief Pulse the DRDY line so the next readForce() fetches a sample
+ */
+static void pulseDrdy() {
+    sim_set_gpio_input(NAU7802_DRDY_PIN, false);
+    sim_set_gpio_input(NAU7802_DRDY_PIN, true);
+}
+
+/**
+ * @brief Feed one command line and run it through the state machine
+ * @param line Command text including trailing newline
+ * @return true if a command was parsed and handled
+ */
+static bool runCommand(const char* line) {
+    sim_feed_serial(line);
+    for (int i = 0; i < 1000; i++) {
+        Command cmd = protocol.processInput();
+        if (cmd != Command::NONE) {
+            stateMachine.handleCommand(cmd);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Drive the async AFE calibration and startup tare to completion
+ * @return true if the load cell settled
+ */
+static bool settleLoadCell() {
+    sim_nau7802_set_raw(BASE_RAW);
+    for (int i = 0; i < 2000; i++) {
+        if (loadCell.startupComplete()) {
+            return true;
+        }
+        sleep_ms(11);       // Clears the 10ms AFE poll throttle
+        pulseDrdy();
+        loadCell.readForce();
+    }
+    return false;
+}
+
+/**
+ * @brief Run the homing sequence against a simulated bottom switch
+ *
+ * The switch is modelled as position-based: it closes (active LOW)
+ * whenever the crosshead is 5mm or more below the starting position.
+ * Alarms are fired from here so stepping advances deterministically.
+ *
+ * @return true once the state machine reaches READY
+ */
+static bool runHoming() {
+    if (!runCommand("HOME\n")) {
+        return false;
+    }
+
+    int32_t switchPos = -stepper.mmToSteps(5.0f);
+    for (int i = 0; i < 2000000; i++) {
+        sim_fire_due_alarms(32);
+        sim_set_gpio_input(LIMIT_SWITCH_BOTTOM_PIN,
+                           stepper.getCurrentPosition() > switchPos);
+        stateMachine.update();
+
+        State state = stateMachine.getState();
+        if (state == State::READY) {
+            return true;
+        }
+        if (state == State::ERROR || state == State::EMERGENCY) {
+            return false;
+        }
+        // Give the core-1 thread a slice to drain commands and advance
+        // the homing phase machine
+        std::this_thread::yield();
+    }
+    return false;
+}
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+static void benchParse() {
+    static const char* inputs[] = {
+        "STATUS\n", "FORCE\n", "POS\n", "SPEED 12.5\n",
+        "MAXFORCE 450\n", "ID\n", "CONFIG\n", "MAXEXT 80\n",
+    };
+
+    const int N = 200000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; i++) {
+        sim_feed_serial(inputs[i & 7]);
+        while (protocol.processInput() == Command::NONE) {
+        }
+    }
+    double dt = elapsedSeconds(t0);
+
+    printf("BENCH parse_throughput      %10.0f cmds/s\n", N / dt);
+
+    // Burst mode - all eight lines land in one feed (one USB buffer on
+    // hardware) and parse out back to back from the RX ring
+    const int B = 25000;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < B; i++) {
+        for (int j = 0; j < 8; j++) {
+            sim_feed_serial(inputs[j]);
+        }
+        for (int j = 0; j < 8; j++) {
+            while (protocol.processInput() == Command::NONE) {
+            }
+        }
+    }
+    double dtb = elapsedSeconds(t1);
+
+    printf("BENCH parse_burst           %10.0f cmds/s\n", B * 8 / dtb);
+}
+
+static void benchSendData() {
+    static const char* names[] = {"ascii ", "binary", "delta "};
+
+    const int N = 200000;
+    for (int mode = 0; mode <= 2; mode++) {
+        protocol.setEncoding((DataEncoding)mode);
+        sim_usb_reset_counters();
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; i++) {
+            // Smoothly drifting samples, like a real pull - what the
+            // delta encoder sees in the field
+            DataPacket packet;
+            packet.timestamp = 123456 + (uint32_t)i * 13;
+            packet.force = 100.0f + i * 0.002f + (i & 15) * 0.03f;
+            packet.extension = i * 0.0005f;
+            packet.stress = 15.43f;
+            packet.strain = 0.0226f;
+
+            protocol.sendData(packet);
+            serialTxDrain();
+        }
+        double dt = elapsedSeconds(t0);
+
+        printf("BENCH senddata_%s     %10.0f pkts/s  (%.1f bytes/pkt)\n",
+               names[mode], N / dt,
+               (double)sim_usb_bytes_written() / N);
+    }
+    protocol.setEncoding(DataEncoding::ASCII);
+}
+
+/**
+ * @brief Worst-case and mean StateMachine::update() latency while RUNNING
+ * @return true if the test ran and stopped cleanly
+ */
+static bool benchUpdateLatency() {
+    // Tighten the force-change trigger so the adaptive sampler has
+    // events to attribute during the run
+    if (!runCommand("EVDELTA 2\n")) {
+        return false;
+    }
+
+    if (!runCommand("START\n") || stateMachine.getState() != State::RUNNING) {
+        return false;
+    }
+
+    // Wait for core 1 to drain the move command - on hardware that
+    // happens within microseconds of startTest(), long before the next
+    // main-loop tick, but the host thread needs a real time slice
+    for (int i = 0; i < 1000000 && !stepper.isMoving(); i++) {
+        std::this_thread::yield();
+    }
+
+    const int N = 20000;
+    double worstUs = 0.0;
+    double totalUs = 0.0;
+    int iterations = 0;
+
+    for (int i = 0; i < N; i++) {
+        // Fresh conversion with a small wiggle, one sample interval apart
+        sim_nau7802_set_raw(BASE_RAW + (i & 63));
+        pulseDrdy();
+        sleep_ms(13);
+
+        auto t0 = std::chrono::steady_clock::now();
+        stateMachine.update();
+        double us = elapsedSeconds(t0) * 1e6;
+
+        if (us > worstUs) worstUs = us;
+        totalUs += us;
+        iterations++;
+
+        protocol.drainData();
+
+        if (stateMachine.getState() != State::RUNNING) {
+            break;
+        }
+    }
+
+    printf("BENCH update_latency        %10.1f us worst, %.2f us mean (%d iters)\n",
+           worstUs, totalUs / iterations, iterations);
+
+    runCommand("STOP\n");
+
+    const TestResult& result = stateMachine.getTestResult();
+    printf("BENCH adaptive_events       T:%lu F:%lu S:%lu P:%lu D:%lu (%lu points)\n",
+           (unsigned long)result.timeSamples, (unsigned long)result.forceEvents,
+           (unsigned long)result.slopeEvents, (unsigned long)result.peakEvents,
+           (unsigned long)result.dropEvents, (unsigned long)result.dataPoints);
+
+    return result.timeSamples + result.forceEvents + result.slopeEvents +
+           result.peakEvents + result.dropEvents > 0;
+}
+
+static void benchRampMath() {
+    // Drive a long constant-direction move through the pulse engine and
+    // fire the step alarms as fast as the math allows
+    pulseEngine.enable();
+    pulseEngine.setMaxSpeed(STEPPER_MAX_SPEED);
+    pulseEngine.move(2000000);
+
+    const uint64_t N = 500000;
+    uint64_t start = sim_step_pulse_count();
+    auto t0 = std::chrono::steady_clock::now();
+    while (sim_step_pulse_count() - start < N) {
+        if (sim_fire_due_alarms(1024) == 0) {
+            // Waiting for core 1 to pick up the move and arm the timer
+            std::this_thread::yield();
+        }
+        if (elapsedSeconds(t0) > 30.0) {
+            break;
+        }
+    }
+    double dt = elapsedSeconds(t0);
+    uint64_t steps = sim_step_pulse_count() - start;
+
+    pulseEngine.stop();
+    sim_fire_due_alarms(1024);
+    pulseEngine.disable();
+
+    printf("BENCH ramp_step_rate        %10.0f steps/s  (%llu steps)\n",
+           steps / dt, (unsigned long long)steps);
+
+    // Ramp table rebuild cost - what a SET_ACCELERATION command pays
+    Stepper rampStepper(STEPPER_STEP_PIN, STEPPER_DIR_PIN, STEPPER_ENABLE_PIN);
+    rampStepper.setMaxSpeed(STEPPER_MAX_SPEED);
+
+    const int rebuilds = 100;
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rebuilds; i++) {
+        rampStepper.setAcceleration((float)(STEPPER_ACCELERATION + i + 1));
+    }
+    double rebuildUs = elapsedSeconds(t1) * 1e6 / rebuilds;
+
+    printf("BENCH ramp_table_rebuild    %10.1f us/rebuild (%d entries)\n",
+           rebuildUs, STEPPER_RAMP_TABLE_SIZE);
+}
+
+/**
+ * @brief Dual-channel smoke test - interleave scheduler end to end
+ *
+ * Enables DUAL mode, gives each channel a distinct raw value and runs a
+ * fixed number of conversions through readForce(). Reports the
+ * primary/secondary sample split so the interleave overhead (settling
+ * discards included) shows up per commit.
+ *
+ * @return true if both channels produced correctly-routed samples
+ */
+static bool benchDualChannel() {
+    if (!runCommand("DUAL 1\n")) {
+        return false;
+    }
+
+    sim_nau7802_set_raw(BASE_RAW);
+    sim_nau7802_set_raw2(BASE_RAW / 4);
+
+    uint32_t prim0 = loadCell.getSampleCount();
+    uint32_t sec0 = loadCell.getSecondarySampleCount();
+
+    // Ten full interleave blocks (8 primary + 2 settle + 1 ch2 + 2 settle)
+    const int conversions = 130;
+    for (int i = 0; i < conversions; i++) {
+        pulseDrdy();
+        loadCell.readForce();
+    }
+
+    uint32_t prim = loadCell.getSampleCount() - prim0;
+    uint32_t sec = loadCell.getSecondarySampleCount() - sec0;
+    bool routed = loadCell.getSecondaryRaw() == BASE_RAW / 4 &&
+                  loadCell.getLastRaw() == BASE_RAW;
+
+    runCommand("DUAL 0\n");
+
+    printf("BENCH dual_channel          %10lu prim + %lu ch2 samples / %d conversions\n",
+           (unsigned long)prim, (unsigned long)sec, conversions);
+
+    return prim > 0 && sec > 0 && routed;
+}
+
+/**
+ * @brief Settings persistence smoke test - SAVE, then reload and compare
+ * @return true if the saved block round-trips through (simulated) flash
+ */
+static bool benchSettings() {
+    if (!runCommand("SAVE\n")) {
+        return false;
+    }
+
+    Settings reloaded;
+    if (!reloaded.load()) {
+        return false;
+    }
+
+    const SettingsBlock& s = reloaded.data();
+    return s.calibrationFactor == loadCell.getCalibrationFactor() &&
+           s.offset == loadCell.getOffset() &&
+           s.afeValid != 0;
+}
+
+/**
+ * @brief Flash capture round-trip - records replayed across page seams
+ *
+ * Captures 50 records (three pages at 21 records per page), then
+ * replays them with dump() into a temp file and checks every value.
+ * Guards the page-aligned record layout: a flat-array read of the
+ * region drifts by the 4 pad bytes at every page end, which only shows
+ * from record 21 onward.
+ *
+ * @return true if every replayed record matches what was recorded
+ */
+static bool benchCapture() {
+    const int n = 50;
+
+    if (!capture.startCapture()) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        capture.record(1000u + i, 200000 + 37 * i, -1200 * i);
+    }
+    capture.stopCapture();
+    if (capture.recordCount() != (uint32_t)n) {
+        return false;
+    }
+
+    // dump() replays with blocking printf - divert stdout to a file so
+    // the lines can be parsed back
+    fflush(stdout);
+    int savedFd = dup(fileno(stdout));
+    if (savedFd < 0 || !freopen("capture_dump.tmp", "w", stdout)) {
+        return false;
+    }
+    capture.dump();
+    fflush(stdout);
+    dup2(savedFd, fileno(stdout));
+    close(savedFd);
+
+    FILE* in = fopen("capture_dump.tmp", "r");
+    if (!in) {
+        return false;
+    }
+
+    char line[64];
+    bool ok = fgets(line, sizeof(line), in) &&
+              strncmp(line, "CAPTURE START 50", 16) == 0;
+    int verified = 0;
+    for (int i = 0; ok && i < n; i++) {
+        unsigned long ts;
+        long raw, pos;
+        ok = fgets(line, sizeof(line), in) &&
+             sscanf(line, "CAP %lu,%ld,%ld", &ts, &raw, &pos) == 3 &&
+             ts == 1000u + i && raw == 200000 + 37 * i && pos == -1200 * i;
+        if (ok) verified++;
+    }
+    ok = ok && fgets(line, sizeof(line), in) &&
+         strncmp(line, "CAPTURE END", 11) == 0;
+
+    fclose(in);
+    remove("capture_dump.tmp");
+
+    printf("BENCH capture_replay        %10d / %d records verified (3 pages)\n",
+           verified, n);
+
+    return ok;
+}
+
+/**
+ * @brief Closed-loop force-hold smoke test against a virtual spring
+ *
+ * Re-homes, then runs HOLD 15 with the specimen modelled as a 1.5 N/mm
+ * spring: each iteration feeds back a raw reading derived from the
+ * crosshead position. The velocity servo should walk the crosshead out
+ * to the 10mm equilibrium and the measured force should settle on the
+ * setpoint. 15 N keeps the simulated raw counts inside the NAU7802's
+ * signed 24-bit range.
+ *
+ * @return true if the held force converged near the setpoint
+ */
+static bool benchHoldForce() {
+    sim_nau7802_set_raw(BASE_RAW);
+
+    // The ramp benchmark left the virtual crosshead half a million steps
+    // up - warp it back so the re-home finishes inside its timeout
+    pulseEngine.setCurrentPosition(stepper.mmToSteps(10.0f));
+    for (int i = 0; i < 1000000 &&
+         stepper.getCurrentPosition() != stepper.mmToSteps(10.0f); i++) {
+        std::this_thread::yield();
+    }
+
+    if (!runHoming()) {
+        return false;
+    }
+
+    if (!runCommand("HOLD 15\n") || stateMachine.getState() != State::RUNNING) {
+        return false;
+    }
+
+    const float stiffness = 1.5f;       // N/mm virtual spring
+    int32_t startPos = stepper.getCurrentPosition();
+    float force = 0.0f;
+    int settled = 0;
+
+    for (int i = 0; i < 5000 && settled < 20; i++) {
+        float ext = stepper.stepsToMm(stepper.getCurrentPosition() - startPos);
+        force = stiffness * (ext > 0.0f ? ext : 0.0f);
+        sim_nau7802_set_raw(BASE_RAW + (int32_t)(force * LOADCELL_CALIBRATION));
+
+        pulseDrdy();
+        sleep_ms(13);       // One 80 SPS sample interval of virtual time
+        stateMachine.update();
+        sim_fire_due_alarms(64);
+        protocol.drainData();
+        std::this_thread::yield();
+
+        if (force > 14.0f && force < 16.0f) {
+            settled++;
+        } else {
+            settled = 0;
+        }
+
+        if (stateMachine.getState() != State::RUNNING) {
+            break;
+        }
+    }
+
+    printf("BENCH hold_force            %10.2f N held (setpoint 15.00)\n", force);
+
+    runCommand("STOP\n");
+    return settled >= 20;
+}
+
+// ============================================================================
+// Main Entry Point
+// ============================================================================
+
+int main() {
+    printf("Tensile Tester host benchmark (simulated hardware)\n");
+
+    // Same bring-up order as main.cpp setup()
+    stdio_init_all();
+    if (!loadCell.begin()) {
+        printf("FAIL: loadCell.begin()\n");
+        return 1;
+    }
+    loadCell.enableDataReadyInterrupt(NAU7802_DRDY_PIN);
+
+    stepper.begin();
+    stepper.setLimitSwitches(LIMIT_SWITCH_TOP_PIN, LIMIT_SWITCH_BOTTOM_PIN);
+    stepper.setMaxSpeed(STEPPER_MAX_SPEED);
+    stepper.setAcceleration(STEPPER_ACCELERATION);
+
+    pulseEngine.begin();
+    stateMachine.begin();
+    protocol.begin();
+
+    if (!settleLoadCell()) {
+        printf("FAIL: load cell startup did not settle\n");
+        return 1;
+    }
+
+    benchParse();
+    benchSendData();
+
+    if (!runHoming()) {
+        printf("FAIL: homing did not reach READY (state %d)\n",
+               (int)stateMachine.getState());
+        return 1;
+    }
+
+    if (!benchUpdateLatency()) {
+        printf("FAIL: test did not start from READY\n");
+        return 1;
+    }
+
+    benchRampMath();
+
+    if (!benchDualChannel()) {
+        printf("FAIL: dual-channel interleave did not route samples\n");
+        return 1;
+    }
+
+    if (!benchSettings()) {
+        printf("FAIL: settings did not round-trip through flash\n");
+        return 1;
+    }
+
+    if (!benchCapture()) {
+        printf("FAIL: capture replay did not match the recorded values\n");
+        return 1;
+    }
+
+    if (!benchHoldForce()) {
+        printf("FAIL: force hold did not converge on setpoint\n");
+        return 1;
+    }
+
+    // Smoke-test the STATS query - the I2C and STEP channels have real
+    // samples in them by now
+    if (!runCommand("STATS\n")) {
+        printf("FAIL: STATS command did not parse\n");
+        return 1;
+    }
+
+    printf("DONE\n");
+    return 0;
+}
@@ -0,0 +1,15 @@
+#ifndef SIM_HARDWARE_CLOCKS_H
+#define SIM_HARDWARE_CLOCKS_H
+
+// Host-build stand-in for pico-sdk hardware/clocks.h - reports the
+// stock RP2040 system clock so clock-derived divider math matches.
+
+#include <stdint.h>
+
+enum clock_index {
+    clk_sys = 5,
+};
+
+uint32_t clock_get_hz(enum clock_index clk);
+
+#endif // SIM_HARDWARE_CLOCKS_H
@@ -0,0 +1,39 @@
+#ifndef SIM_HARDWARE_DMA_H
+#define SIM_HARDWARE_DMA_H
+
+// Host-build stand-in for pico-sdk hardware/dma.h. The host has no DMA
+// engine, so dma_claim_unused_channel() always fails and callers take
+// their documented fallbacks (LoadCell drops to short blocking reads,
+// StepPulse skips burst mode). Everything else is a no-op.
+
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8  = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config* c,
+                                           enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config* c, bool incr);
+void channel_config_set_write_increment(dma_channel_config* c, bool incr);
+void channel_config_set_dreq(dma_channel_config* c, uint dreq);
+void dma_channel_configure(uint channel, const dma_channel_config* config,
+                           volatile void* write_addr,
+                           const volatile void* read_addr,
+                           uint transfer_count, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void* addr, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void* addr, bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t count, bool trigger);
+bool dma_channel_is_busy(uint channel);
+
+#endif // SIM_HARDWARE_DMA_H
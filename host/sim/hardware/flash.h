@@ -0,0 +1,22 @@
+#ifndef SIM_HARDWARE_FLASH_H
+#define SIM_HARDWARE_FLASH_H
+
+// Host-build stand-in for pico-sdk hardware/flash.h. Flash is a 2MB
+// in-RAM array; erase fills with 0xFF, program copies bytes in, and
+// XIP_BASE maps to the array base so memory-mapped reads (Capture::dump)
+// work unchanged.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "pico_sim.h"
+
+#define FLASH_PAGE_SIZE   256u
+#define FLASH_SECTOR_SIZE 4096u
+
+#define XIP_BASE ((uintptr_t)sim_flash_base())
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count);
+
+#endif // SIM_HARDWARE_FLASH_H
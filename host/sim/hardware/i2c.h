@@ -0,0 +1,33 @@
+#ifndef SIM_HARDWARE_I2C_H
+#define SIM_HARDWARE_I2C_H
+
+// Host-build stand-in for pico-sdk hardware/i2c.h. The bus carries a
+// behavioural NAU7802 model: a register file with auto-incrementing
+// read pointer, instant power-up-ready and AFE calibration, and ADC
+// result registers fed from sim_nau7802_set_raw().
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+typedef struct i2c_inst {
+    int unused;
+} i2c_inst_t;
+
+typedef struct {
+    volatile uint32_t data_cmd;
+} i2c_hw_t;
+
+extern i2c_inst_t sim_i2c0_inst;
+#define i2c0 (&sim_i2c0_inst)
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src,
+                       size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst,
+                      size_t len, bool nostop);
+i2c_hw_t* i2c_get_hw(i2c_inst_t* i2c);
+uint i2c_get_dreq(i2c_inst_t* i2c, bool is_tx);
+
+#endif // SIM_HARDWARE_I2C_H
@@ -0,0 +1,43 @@
+#ifndef SIM_HARDWARE_PIO_H
+#define SIM_HARDWARE_PIO_H
+
+// Host-build stand-in for pico-sdk hardware/pio.h. The step pulse
+// program is not executed - every word pushed into the TX FIFO counts
+// as one emitted STEP pulse (sim_step_pulse_count()), and the FIFO is
+// never full, so Stepper::step() behaves as on hardware.
+
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+typedef struct pio_program {
+    const uint16_t* instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+typedef struct {
+    volatile uint32_t txf[4];
+} pio_hw_t;
+
+typedef pio_hw_t* PIO;
+
+extern pio_hw_t sim_pio0_hw;
+#define pio0 (&sim_pio0_hw)
+
+typedef struct {
+    uint32_t unused;
+} pio_sm_config;
+
+int pio_claim_unused_sm(PIO pio, bool required);
+uint pio_add_program(PIO pio, const pio_program_t* program);
+void pio_sm_put(PIO pio, uint sm, uint32_t data);
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm);
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+void pio_gpio_init(PIO pio, uint pin);
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin, uint count, bool is_out);
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config* config);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+
+#endif // SIM_HARDWARE_PIO_H
@@ -0,0 +1,25 @@
+#ifndef SIM_HARDWARE_STRUCTS_SIO_H
+#define SIM_HARDWARE_STRUCTS_SIO_H
+
+#include <stdint.h>
+
+// Minimal SIO model: the firmware writes pin masks to the set/clear
+// registers, so each is a write-only proxy whose assignment operator
+// routes into the sim GPIO pin array.
+
+struct sim_sio_set_reg {
+    void operator=(uint32_t mask);
+};
+
+struct sim_sio_clr_reg {
+    void operator=(uint32_t mask);
+};
+
+typedef struct {
+    sim_sio_set_reg gpio_set;
+    sim_sio_clr_reg gpio_clr;
+} sio_hw_t;
+
+extern sio_hw_t* const sio_hw;
+
+#endif // SIM_HARDWARE_STRUCTS_SIO_H
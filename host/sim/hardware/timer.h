@@ -0,0 +1,9 @@
+#ifndef SIM_HARDWARE_TIMER_H
+#define SIM_HARDWARE_TIMER_H
+
+// Host-build stand-in for pico-sdk hardware/timer.h - the time and
+// alarm API lives in the pico/stdlib.h stub.
+
+#include "pico/stdlib.h"
+
+#endif // SIM_HARDWARE_TIMER_H
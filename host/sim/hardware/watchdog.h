@@ -0,0 +1,11 @@
+#ifndef SIM_HARDWARE_WATCHDOG_H
+#define SIM_HARDWARE_WATCHDOG_H
+
+// Host-build stand-in for pico-sdk hardware/watchdog.h - no-ops.
+
+#include <stdint.h>
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_update(void);
+
+#endif // SIM_HARDWARE_WATCHDOG_H
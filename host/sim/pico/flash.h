@@ -0,0 +1,13 @@
+#ifndef SIM_PICO_FLASH_H
+#define SIM_PICO_FLASH_H
+
+// Host-build stand-in for pico-sdk pico/flash.h. There is no XIP to
+// protect on the host, so flash_safe_execute just runs the callback.
+
+#include <stdint.h>
+
+int flash_safe_execute(void (*func)(void*), void* param,
+                       uint32_t enter_exit_timeout_ms);
+bool flash_safe_execute_core_init(void);
+
+#endif // SIM_PICO_FLASH_H
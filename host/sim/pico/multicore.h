@@ -0,0 +1,10 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+// Host-build stand-in for pico-sdk pico/multicore.h. Core 1 becomes a
+// detached host thread, so the PulseEngine command loop runs
+// concurrently with the benchmark just as it does on the RP2040.
+
+void multicore_launch_core1(void (*entry)(void));
+
+#endif // SIM_PICO_MULTICORE_H
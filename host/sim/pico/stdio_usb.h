@@ -0,0 +1,9 @@
+#ifndef SIM_PICO_STDIO_USB_H
+#define SIM_PICO_STDIO_USB_H
+
+// Host-build stand-in for pico-sdk pico/stdio_usb.h - the host is
+// always "connected".
+
+bool stdio_usb_connected(void);
+
+#endif // SIM_PICO_STDIO_USB_H
@@ -0,0 +1,47 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+// Host-build stand-in for pico-sdk pico/stdlib.h. Simulated time is
+// real host time plus an offset; sleep_*() advance the offset instantly
+// so firmware settling loops cost nothing on the host. Alarms are
+// queued and fired explicitly via sim_fire_due_alarms().
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "hardware/gpio.h"
+
+#define PICO_OK             0
+#define PICO_ERROR_TIMEOUT  (-1)
+
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void* user_data);
+
+void stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t t);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void tight_loop_contents(void);
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback,
+                           void* user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+
+// Alarm pools: on hardware these pin callbacks to the creating core's
+// timer IRQ; the sim has one timeline, so pool alarms just forward to
+// the default alarm queue.
+typedef struct alarm_pool alarm_pool_t;
+
+alarm_pool_t* alarm_pool_create_with_unused_hardware_alarm(unsigned int max_timers);
+alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t* pool, uint64_t us,
+                                      alarm_callback_t callback,
+                                      void* user_data, bool fire_if_past);
+
+#endif // SIM_PICO_STDLIB_H
@@ -0,0 +1,22 @@
+#ifndef SIM_PICO_UTIL_QUEUE_H
+#define SIM_PICO_UTIL_QUEUE_H
+
+// Host-build stand-in for pico-sdk pico/util/queue.h. Backed by a
+// mutex-protected ring (the real one is lock-free between cores);
+// queue_add_blocking really blocks, so cross-"core" backpressure
+// behaves as on hardware.
+
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+typedef struct queue {
+    void* impl;
+} queue_t;
+
+void queue_init(queue_t* q, uint element_size, uint element_count);
+bool queue_try_add(queue_t* q, const void* data);
+void queue_add_blocking(queue_t* q, const void* data);
+bool queue_try_remove(queue_t* q, void* data);
+
+#endif // SIM_PICO_UTIL_QUEUE_H
@@ -0,0 +1,704 @@
+/**
+ * @file pico_sim.cpp
+ * @brief Simulated Pico hardware backing the host-native build
+ *
+ * One translation unit implements every pico-sdk symbol the firmware
+ * uses, against in-RAM state: a GPIO level array with edge-IRQ
+ * dispatch, a behavioural NAU7802 register model on the I2C stubs, a
+ * mutex-protected alarm list fired on demand, a 2MB flash array, and
+ * counting sinks for PIO step pulses and USB CDC bytes. Simulated time
+ * is real host time plus an offset that sleeps and alarm firing advance
+ * instantly.
+ */
+
+#include "pico_sim.h"
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "pico/multicore.h"
+#include "pico/util/queue.h"
+#include "pico/flash.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/sio.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/watchdog.h"
+#include "tusb.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Time - real host time plus a jumpable offset
+// ============================================================================
+
+static const std::chrono::steady_clock::time_point s_bootTime =
+    std::chrono::steady_clock::now();
+static std::atomic<uint64_t> s_timeOffsetUs{0};
+
+uint64_t time_us_64(void) {
+    uint64_t real = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - s_bootTime).count();
+    return real + s_timeOffsetUs.load(std::memory_order_relaxed);
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void) {
+    return time_us_64();
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+void sleep_us(uint64_t us) {
+    s_timeOffsetUs.fetch_add(us, std::memory_order_relaxed);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000);
+}
+
+void tight_loop_contents(void) {
+    std::this_thread::yield();
+}
+
+// ============================================================================
+// Alarms - sorted-on-fire list, driven by sim_fire_due_alarms()
+// ============================================================================
+
+struct SimAlarm {
+    alarm_id_t id;
+    uint64_t deadline;
+    alarm_callback_t callback;
+    void* userData;
+};
+
+static std::mutex s_alarmMutex;
+static std::vector<SimAlarm> s_alarms;
+static alarm_id_t s_nextAlarmId = 1;
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback,
+                           void* user_data, bool fire_if_past) {
+    (void)fire_if_past;
+    std::lock_guard<std::mutex> lock(s_alarmMutex);
+    SimAlarm alarm{s_nextAlarmId++, time_us_64() + us, callback, user_data};
+    s_alarms.push_back(alarm);
+    return alarm.id;
+}
+
+// One opaque pool object is enough: the sim has a single alarm
+// timeline, so pool alarms forward to the default queue above.
+static struct alarm_pool* s_simPool = (struct alarm_pool*)&s_alarms;
+
+alarm_pool_t* alarm_pool_create_with_unused_hardware_alarm(unsigned int max_timers) {
+    (void)max_timers;
+    return s_simPool;
+}
+
+alarm_id_t alarm_pool_add_alarm_in_us(alarm_pool_t* pool, uint64_t us,
+                                      alarm_callback_t callback,
+                                      void* user_data, bool fire_if_past) {
+    (void)pool;
+    return add_alarm_in_us(us, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    std::lock_guard<std::mutex> lock(s_alarmMutex);
+    for (size_t i = 0; i < s_alarms.size(); i++) {
+        if (s_alarms[i].id == id) {
+            s_alarms.erase(s_alarms.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int sim_fire_due_alarms(int maxFired) {
+    int fired = 0;
+    while (fired < maxFired) {
+        SimAlarm alarm;
+        {
+            std::lock_guard<std::mutex> lock(s_alarmMutex);
+            if (s_alarms.empty()) {
+                break;
+            }
+            size_t earliest = 0;
+            for (size_t i = 1; i < s_alarms.size(); i++) {
+                if (s_alarms[i].deadline < s_alarms[earliest].deadline) {
+                    earliest = i;
+                }
+            }
+            alarm = s_alarms[earliest];
+            s_alarms.erase(s_alarms.begin() + earliest);
+        }
+
+        // Jump simulated time forward to the deadline before firing
+        uint64_t now = time_us_64();
+        if (alarm.deadline > now) {
+            s_timeOffsetUs.fetch_add(alarm.deadline - now, std::memory_order_relaxed);
+        }
+
+        int64_t ret = alarm.callback(alarm.id, alarm.userData);
+        fired++;
+
+        if (ret < 0) {
+            // Re-arm relative to the previous deadline (drift-free)
+            alarm.deadline += (uint64_t)(-ret);
+            std::lock_guard<std::mutex> lock(s_alarmMutex);
+            s_alarms.push_back(alarm);
+        } else if (ret > 0) {
+            // Re-arm relative to the callback return time
+            alarm.deadline = time_us_64() + (uint64_t)ret;
+            std::lock_guard<std::mutex> lock(s_alarmMutex);
+            s_alarms.push_back(alarm);
+        }
+    }
+    return fired;
+}
+
+// ============================================================================
+// GPIO - level array with single registered edge-IRQ callback
+// ============================================================================
+
+struct SimGpio {
+    bool level;
+    bool isOutput;
+    uint32_t irqMask;
+};
+
+static SimGpio s_gpioPins[64];
+static gpio_irq_callback_t s_gpioCallback = nullptr;
+
+void gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    if (gpio < 64) s_gpioPins[gpio].isOutput = out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (gpio < 64) s_gpioPins[gpio].level = value;
+}
+
+// SIO set/clear register proxies (hardware/structs/sio.h)
+static sio_hw_t s_sioHw;
+sio_hw_t* const sio_hw = &s_sioHw;
+
+void sim_sio_set_reg::operator=(uint32_t mask) {
+    for (uint gpio = 0; mask != 0; gpio++, mask >>= 1) {
+        if (mask & 1u) gpio_put(gpio, true);
+    }
+}
+
+void sim_sio_clr_reg::operator=(uint32_t mask) {
+    for (uint gpio = 0; mask != 0; gpio++, mask >>= 1) {
+        if (mask & 1u) gpio_put(gpio, false);
+    }
+}
+
+bool gpio_get(uint gpio) {
+    return gpio < 64 ? s_gpioPins[gpio].level : false;
+}
+
+void gpio_pull_up(uint gpio) {
+    // An undriven input reads its pull level
+    if (gpio < 64 && !s_gpioPins[gpio].isOutput) s_gpioPins[gpio].level = true;
+}
+
+void gpio_pull_down(uint gpio) {
+    if (gpio < 64 && !s_gpioPins[gpio].isOutput) s_gpioPins[gpio].level = false;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask,
+                                        bool enabled, gpio_irq_callback_t callback) {
+    s_gpioCallback = callback;
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (gpio >= 64) return;
+    if (enabled) {
+        s_gpioPins[gpio].irqMask |= event_mask;
+    } else {
+        s_gpioPins[gpio].irqMask &= ~event_mask;
+    }
+}
+
+void sim_set_gpio_input(uint8_t pin, bool level) {
+    if (pin >= 64) return;
+    bool old = s_gpioPins[pin].level;
+    s_gpioPins[pin].level = level;
+
+    uint32_t events = 0;
+    if (!old && level) events |= GPIO_IRQ_EDGE_RISE;
+    if (old && !level) events |= GPIO_IRQ_EDGE_FALL;
+
+    events &= s_gpioPins[pin].irqMask;
+    if (events != 0 && s_gpioCallback != nullptr) {
+        s_gpioCallback(pin, events);
+    }
+}
+
+bool sim_get_gpio(uint8_t pin) {
+    return gpio_get(pin);
+}
+
+// ============================================================================
+// I2C - behavioural NAU7802 register model
+// ============================================================================
+
+// Register/bit numbers mirrored from LoadCell.h - kept as plain values
+// here so the sim does not depend on firmware headers
+#define SIM_NAU_REG_PU_CTRL  0x00
+#define SIM_NAU_REG_CTRL2    0x02
+#define SIM_NAU_REG_ADCO_B2  0x12
+#define SIM_NAU_REG_REVISION 0x1F
+#define SIM_NAU_PU_CTRL_PUD  0x02
+#define SIM_NAU_PU_CTRL_PUR  0x08
+#define SIM_NAU_PU_CTRL_CR   0x20
+#define SIM_NAU_CTRL2_CALS   0x04
+#define SIM_NAU_CTRL2_CHS    0x80
+
+i2c_inst_t sim_i2c0_inst;
+
+static uint8_t s_nauRegs[0x20];
+static uint8_t s_nauPointer = 0;
+static std::atomic<int32_t> s_nauRaw{0};
+static std::atomic<int32_t> s_nauRaw2{0};
+static i2c_hw_t s_i2cHw;
+
+void sim_nau7802_set_raw(int32_t raw) {
+    s_nauRaw.store(raw, std::memory_order_relaxed);
+}
+
+void sim_nau7802_set_raw2(int32_t raw) {
+    s_nauRaw2.store(raw, std::memory_order_relaxed);
+}
+
+static void nauWriteRegister(uint8_t reg, uint8_t value) {
+    if (reg >= sizeof(s_nauRegs)) return;
+    switch (reg) {
+        case SIM_NAU_REG_PU_CTRL:
+            // Digital power-up is instantly "ready"
+            if (value & SIM_NAU_PU_CTRL_PUD) value |= SIM_NAU_PU_CTRL_PUR;
+            s_nauRegs[reg] = value;
+            break;
+        case SIM_NAU_REG_CTRL2:
+            // AFE calibration completes instantly: CALS self-clears,
+            // CAL_ERR stays 0
+            s_nauRegs[reg] = value & (uint8_t)~SIM_NAU_CTRL2_CALS;
+            break;
+        default:
+            s_nauRegs[reg] = value;
+            break;
+    }
+}
+
+static uint8_t nauReadRegister(uint8_t reg) {
+    // ADCO reflects whichever input the CHS mux bit currently selects
+    int32_t raw = (s_nauRegs[SIM_NAU_REG_CTRL2] & SIM_NAU_CTRL2_CHS)
+                      ? s_nauRaw2.load(std::memory_order_relaxed)
+                      : s_nauRaw.load(std::memory_order_relaxed);
+    switch (reg) {
+        case SIM_NAU_REG_PU_CTRL:
+            // A conversion is always ready
+            return s_nauRegs[reg] | SIM_NAU_PU_CTRL_CR;
+        case SIM_NAU_REG_ADCO_B2:
+            return (uint8_t)(raw >> 16);
+        case SIM_NAU_REG_ADCO_B2 + 1:
+            return (uint8_t)(raw >> 8);
+        case SIM_NAU_REG_ADCO_B2 + 2:
+            return (uint8_t)raw;
+        case SIM_NAU_REG_REVISION:
+            return 0x0F;
+        default:
+            return reg < sizeof(s_nauRegs) ? s_nauRegs[reg] : 0;
+    }
+}
+
+uint i2c_init(i2c_inst_t* i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t* i2c, uint8_t addr, const uint8_t* src,
+                       size_t len, bool nostop) {
+    (void)i2c;
+    (void)addr;
+    (void)nostop;
+    if (len == 0) return 0;
+    // First byte sets the register pointer, remaining bytes write
+    // consecutive registers (the NAU7802 auto-increments)
+    s_nauPointer = src[0];
+    for (size_t i = 1; i < len; i++) {
+        nauWriteRegister((uint8_t)(s_nauPointer + (i - 1)), src[i]);
+    }
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t* i2c, uint8_t addr, uint8_t* dst,
+                      size_t len, bool nostop) {
+    (void)i2c;
+    (void)addr;
+    (void)nostop;
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = nauReadRegister((uint8_t)(s_nauPointer + i));
+    }
+    s_nauPointer = (uint8_t)(s_nauPointer + len);
+    return (int)len;
+}
+
+i2c_hw_t* i2c_get_hw(i2c_inst_t* i2c) {
+    (void)i2c;
+    return &s_i2cHw;
+}
+
+uint i2c_get_dreq(i2c_inst_t* i2c, bool is_tx) {
+    (void)i2c;
+    (void)is_tx;
+    return 0;
+}
+
+// ============================================================================
+// DMA - claiming always fails; callers take their non-DMA fallbacks
+// ============================================================================
+
+int dma_claim_unused_channel(bool required) {
+    (void)required;
+    return -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void)channel;
+    return dma_channel_config{0};
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config* c,
+                                           enum dma_channel_transfer_size size) {
+    (void)c;
+    (void)size;
+}
+
+void channel_config_set_read_increment(dma_channel_config* c, bool incr) {
+    (void)c;
+    (void)incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config* c, bool incr) {
+    (void)c;
+    (void)incr;
+}
+
+void channel_config_set_dreq(dma_channel_config* c, uint dreq) {
+    (void)c;
+    (void)dreq;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config* config,
+                           volatile void* write_addr,
+                           const volatile void* read_addr,
+                           uint transfer_count, bool trigger) {
+    (void)channel;
+    (void)config;
+    (void)write_addr;
+    (void)read_addr;
+    (void)transfer_count;
+    (void)trigger;
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void* addr, bool trigger) {
+    (void)channel;
+    (void)addr;
+    (void)trigger;
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void* addr, bool trigger) {
+    (void)channel;
+    (void)addr;
+    (void)trigger;
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t count, bool trigger) {
+    (void)channel;
+    (void)count;
+    (void)trigger;
+}
+
+bool dma_channel_is_busy(uint channel) {
+    (void)channel;
+    return false;
+}
+
+// ============================================================================
+// PIO - every TX FIFO word counts as one emitted STEP pulse
+// ============================================================================
+
+pio_hw_t sim_pio0_hw;
+
+static std::atomic<uint64_t> s_stepPulseCount{0};
+
+uint64_t sim_step_pulse_count(void) {
+    return s_stepPulseCount.load(std::memory_order_relaxed);
+}
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    (void)pio;
+    (void)required;
+    return 0;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t* program) {
+    (void)pio;
+    (void)program;
+    return 0;
+}
+
+void pio_sm_put(PIO pio, uint sm, uint32_t data) {
+    (void)pio;
+    (void)sm;
+    (void)data;
+    s_stepPulseCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm) {
+    (void)pio;
+    (void)sm;
+    return false;
+}
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm) {
+    (void)pio;
+    (void)sm;
+    return true;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) {
+    (void)pio;
+    (void)sm;
+    (void)is_tx;
+    return 0;
+}
+
+void pio_gpio_init(PIO pio, uint pin) {
+    (void)pio;
+    (void)pin;
+}
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin, uint count, bool is_out) {
+    (void)pio;
+    (void)sm;
+    (void)pin;
+    (void)count;
+    (void)is_out;
+}
+
+void pio_sm_init(PIO pio, uint sm, uint initial_pc, const pio_sm_config* config) {
+    (void)pio;
+    (void)sm;
+    (void)initial_pc;
+    (void)config;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) {
+    (void)pio;
+    (void)sm;
+    (void)enabled;
+}
+
+// ============================================================================
+// Clocks / watchdog
+// ============================================================================
+
+uint32_t clock_get_hz(enum clock_index clk) {
+    (void)clk;
+    return 125000000;
+}
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug) {
+    (void)delay_ms;
+    (void)pause_on_debug;
+}
+
+void watchdog_update(void) {
+}
+
+// ============================================================================
+// Flash - 2MB in-RAM array, XIP_BASE maps to its base address
+// ============================================================================
+
+#define SIM_FLASH_SIZE (2u * 1024u * 1024u)
+
+static std::vector<uint8_t>& simFlash() {
+    static std::vector<uint8_t> flash(SIM_FLASH_SIZE, 0xFF);
+    return flash;
+}
+
+const uint8_t* sim_flash_base(void) {
+    return simFlash().data();
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    if (flash_offs >= SIM_FLASH_SIZE) return;
+    if (count > SIM_FLASH_SIZE - flash_offs) count = SIM_FLASH_SIZE - flash_offs;
+    std::memset(simFlash().data() + flash_offs, 0xFF, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count) {
+    if (flash_offs >= SIM_FLASH_SIZE) return;
+    if (count > SIM_FLASH_SIZE - flash_offs) count = SIM_FLASH_SIZE - flash_offs;
+    std::memcpy(simFlash().data() + flash_offs, data, count);
+}
+
+int flash_safe_execute(void (*func)(void*), void* param,
+                       uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+bool flash_safe_execute_core_init(void) {
+    return true;
+}
+
+// ============================================================================
+// Multicore / queue
+// ============================================================================
+
+void multicore_launch_core1(void (*entry)(void)) {
+    std::thread(entry).detach();
+}
+
+struct SimQueue {
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::deque<std::vector<uint8_t>> items;
+    size_t elementSize;
+    size_t maxCount;
+};
+
+void queue_init(queue_t* q, uint element_size, uint element_count) {
+    SimQueue* impl = new SimQueue();
+    impl->elementSize = element_size;
+    impl->maxCount = element_count;
+    q->impl = impl;
+}
+
+bool queue_try_add(queue_t* q, const void* data) {
+    SimQueue* impl = (SimQueue*)q->impl;
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    if (impl->items.size() >= impl->maxCount) {
+        return false;
+    }
+    const uint8_t* bytes = (const uint8_t*)data;
+    impl->items.emplace_back(bytes, bytes + impl->elementSize);
+    return true;
+}
+
+void queue_add_blocking(queue_t* q, const void* data) {
+    SimQueue* impl = (SimQueue*)q->impl;
+    std::unique_lock<std::mutex> lock(impl->mutex);
+    impl->notFull.wait(lock, [impl] { return impl->items.size() < impl->maxCount; });
+    const uint8_t* bytes = (const uint8_t*)data;
+    impl->items.emplace_back(bytes, bytes + impl->elementSize);
+}
+
+bool queue_try_remove(queue_t* q, void* data) {
+    SimQueue* impl = (SimQueue*)q->impl;
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    if (impl->items.empty()) {
+        return false;
+    }
+    std::memcpy(data, impl->items.front().data(), impl->elementSize);
+    impl->items.pop_front();
+    impl->notFull.notify_one();
+    return true;
+}
+
+// ============================================================================
+// Serial - RX fed by the harness, TX counted by the tud_cdc stubs
+// ============================================================================
+
+static std::mutex s_serialMutex;
+static std::deque<char> s_serialRx;
+static std::atomic<uint64_t> s_usbBytesWritten{0};
+
+void stdio_init_all(void) {
+}
+
+bool stdio_usb_connected(void) {
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    std::lock_guard<std::mutex> lock(s_serialMutex);
+    if (s_serialRx.empty()) {
+        return PICO_ERROR_TIMEOUT;
+    }
+    int c = (unsigned char)s_serialRx.front();
+    s_serialRx.pop_front();
+    return c;
+}
+
+void sim_feed_serial(const char* text) {
+    std::lock_guard<std::mutex> lock(s_serialMutex);
+    while (*text) {
+        s_serialRx.push_back(*text++);
+    }
+}
+
+uint32_t tud_cdc_available(void) {
+    std::lock_guard<std::mutex> lock(s_serialMutex);
+    return (uint32_t)s_serialRx.size();
+}
+
+uint32_t tud_cdc_read(void* buffer, uint32_t bufsize) {
+    std::lock_guard<std::mutex> lock(s_serialMutex);
+    uint8_t* out = (uint8_t*)buffer;
+    uint32_t n = 0;
+    while (n < bufsize && !s_serialRx.empty()) {
+        out[n++] = (uint8_t)s_serialRx.front();
+        s_serialRx.pop_front();
+    }
+    return n;
+}
+
+uint32_t tud_cdc_write_available(void) {
+    return 4096;
+}
+
+uint32_t tud_cdc_write(const void* buffer, uint32_t bufsize) {
+    (void)buffer;
+    s_usbBytesWritten.fetch_add(bufsize, std::memory_order_relaxed);
+    return bufsize;
+}
+
+uint32_t tud_cdc_write_flush(void) {
+    return 0;
+}
+
+uint64_t sim_usb_bytes_written(void) {
+    return s_usbBytesWritten.load(std::memory_order_relaxed);
+}
+
+void sim_usb_reset_counters(void) {
+    s_usbBytesWritten.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,94 @@
+#ifndef PICO_SIM_H
+#define PICO_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Control interface for the simulated Pico hardware
+ *
+ * The headers under host/sim/ mirror the pico-sdk include layout so the
+ * firmware sources compile on the host unmodified; this header is the
+ * back door the benchmark harness uses to drive the simulation - set
+ * GPIO input levels (firing registered edge IRQs), feed ADC samples and
+ * serial input, fire pending timer alarms, and read the output counters.
+ *
+ * Simulated time is real host time plus an offset: sleep_ms()/sleep_us()
+ * advance the offset instantly, and firing an alarm whose deadline is in
+ * the future jumps the offset to the deadline. Firmware timing logic
+ * behaves as on hardware while benchmarks never actually wait.
+ */
+
+/**
+ * @brief Set the level of a GPIO input pin
+ *
+ * Fires the registered GPIO IRQ callback if the resulting edge matches
+ * an enabled event mask - exactly how limit switches, DRDY and the
+ * E-stop button reach the firmware on hardware.
+ *
+ * @param pin GPIO number
+ * @param level New input level
+ */
+void sim_set_gpio_input(uint8_t pin, bool level);
+
+/**
+ * @brief Read the current level of a GPIO pin (input or output)
+ * @param pin GPIO number
+ * @return Current level
+ */
+bool sim_get_gpio(uint8_t pin);
+
+/**
+ * @brief Set the 24-bit conversion result the NAU7802 model returns
+ * @param raw Raw ADC counts (sign-extended 24-bit)
+ */
+void sim_nau7802_set_raw(int32_t raw);
+
+/**
+ * @brief Set the channel-2 conversion result (read when CTRL2 CHS is set)
+ * @param raw Raw ADC counts (sign-extended 24-bit)
+ */
+void sim_nau7802_set_raw2(int32_t raw);
+
+/**
+ * @brief Append text to the serial RX stream read by getchar_timeout_us()
+ * @param text NUL-terminated text to feed
+ */
+void sim_feed_serial(const char* text);
+
+/**
+ * @brief Fire pending timer alarms, earliest deadline first
+ *
+ * If the earliest alarm lies in the future, simulated time jumps to its
+ * deadline before the callback runs. Negative/positive callback returns
+ * re-arm the alarm with pico-sdk semantics.
+ *
+ * @param maxFired Maximum number of alarms to fire
+ * @return Number of alarms actually fired
+ */
+int sim_fire_due_alarms(int maxFired);
+
+/**
+ * @brief Get the number of STEP pulses pushed into the PIO TX FIFO
+ * @return Pulse count since start
+ */
+uint64_t sim_step_pulse_count(void);
+
+/**
+ * @brief Get the number of bytes written through tud_cdc_write()
+ * @return Byte count since start (or last reset)
+ */
+uint64_t sim_usb_bytes_written(void);
+
+/**
+ * @brief Reset the USB byte counter
+ */
+void sim_usb_reset_counters(void);
+
+/**
+ * @brief Get the base address of the simulated 2MB flash array
+ * @return Pointer to simulated flash (XIP_BASE maps here)
+ */
+const uint8_t* sim_flash_base(void);
+
+#endif // PICO_SIM_H
@@ -0,0 +1,25 @@
+#ifndef SIM_STEP_PULSE_PIO_H
+#define SIM_STEP_PULSE_PIO_H
+
+// Host-build stand-in for the pioasm-generated step_pulse.pio.h. The
+// program itself never executes - pio_sm_put() counts pulses instead -
+// so the init helper is a no-op and the program body is a placeholder.
+
+#include "hardware/pio.h"
+
+static const uint16_t step_pulse_program_instructions[] = {0x0000};
+
+static const pio_program_t step_pulse_program = {
+    step_pulse_program_instructions,
+    1,
+    -1,
+};
+
+static inline void step_pulse_program_init(PIO pio, uint sm, uint offset, uint pin) {
+    (void)pio;
+    (void)sm;
+    (void)offset;
+    (void)pin;
+}
+
+#endif // SIM_STEP_PULSE_PIO_H
@@ -0,0 +1,18 @@
+#ifndef SIM_TUSB_H
+#define SIM_TUSB_H
+
+// Host-build stand-in for TinyUSB's CDC API. Writes land in a byte
+// counter (sim_usb_bytes_written) and the FIFO always reports a full
+// endpoint's worth of space - the host never pushes back. Reads pull
+// from the same harness-fed buffer as getchar_timeout_us.
+
+#include <stdint.h>
+
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_cdc_write(const void* buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+
+uint32_t tud_cdc_available(void);
+uint32_t tud_cdc_read(void* buffer, uint32_t bufsize);
+
+#endif // SIM_TUSB_H
@@ -0,0 +1,98 @@
+#include "Analytics.h"
+
+Analytics::Analytics()
+    : _areaMm2(0.0f)
+    , _gaugeMm(0.0f)
+    , _n(0)
+    , _sumX(0.0f)
+    , _sumY(0.0f)
+    , _sumXY(0.0f)
+    , _sumXX(0.0f)
+    , _energyNmm(0.0f)
+    , _lastForce(0.0f)
+    , _lastExtension(0.0f)
+    , _hasLast(false)
+{
+}
+
+void Analytics::setArea(float areaMm2) {
+    _areaMm2 = (areaMm2 > 0.0f) ? areaMm2 : 0.0f;
+}
+
+void Analytics::setGaugeLength(float gaugeMm) {
+    _gaugeMm = (gaugeMm > 0.0f) ? gaugeMm : 0.0f;
+}
+
+float Analytics::getArea() const {
+    return _areaMm2;
+}
+
+float Analytics::getGaugeLength() const {
+    return _gaugeMm;
+}
+
+bool Analytics::hasGeometry() const {
+    return _areaMm2 > 0.0f && _gaugeMm > 0.0f;
+}
+
+void Analytics::reset() {
+    _n = 0;
+    _sumX = 0.0f;
+    _sumY = 0.0f;
+    _sumXY = 0.0f;
+    _sumXX = 0.0f;
+    _energyNmm = 0.0f;
+    _lastForce = 0.0f;
+    _lastExtension = 0.0f;
+    _hasLast = false;
+}
+
+void Analytics::addSample(float forceN, float extensionMm) {
+    // Energy needs no geometry - trapezoid on the force-extension curve
+    if (_hasLast) {
+        _energyNmm += 0.5f * (forceN + _lastForce) * (extensionMm - _lastExtension);
+    }
+    _lastForce = forceN;
+    _lastExtension = extensionMm;
+    _hasLast = true;
+
+    // Modulus sums only make sense with full geometry
+    if (!hasGeometry()) {
+        return;
+    }
+
+    float x = strain(extensionMm);
+    float y = stress(forceN);
+    _n++;
+    _sumX += x;
+    _sumY += y;
+    _sumXY += x * y;
+    _sumXX += x * x;
+}
+
+float Analytics::stress(float forceN) const {
+    if (_areaMm2 <= 0.0f) return 0.0f;
+    return forceN / _areaMm2;       // N/mm^2 = MPa
+}
+
+float Analytics::strain(float extensionMm) const {
+    if (_gaugeMm <= 0.0f) return 0.0f;
+    return extensionMm / _gaugeMm;
+}
+
+float Analytics::modulus() const {
+    if (_n < 2) return 0.0f;
+
+    float denom = (float)_n * _sumXX - _sumX * _sumX;
+    if (denom <= 0.0f) return 0.0f;
+
+    return ((float)_n * _sumXY - _sumX * _sumY) / denom;
+}
+
+float Analytics::energy() const {
+    return _energyNmm / 1000.0f;    // N*mm -> J
+}
+
+uint32_t Analytics::sampleCount() const {
+    return _n;
+}
@@ -0,0 +1,127 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <stdint.h>
+#include "Config.h"
+
+/**
+ * @brief Incremental streaming analytics for tensile test curves
+ *
+ * Computes stress, strain, a running least-squares slope of the
+ * stress-strain curve (elastic modulus estimate) and energy under the
+ * force-extension curve, all updated in O(1) per sample as data points
+ * are recorded. Replaces the full-curve post-processing pass the host
+ * used to run after each test - modulus and energy are live during the
+ * test with no host round-trip.
+ *
+ * All math is float, but it runs once per recorded data point (20 Hz),
+ * not per ADC conversion, so it stays off the acquisition hot path.
+ */
+class Analytics {
+public:
+    /**
+     * @brief Construct a new Analytics object
+     */
+    Analytics();
+
+    /**
+     * @brief Set specimen cross-sectional area
+     * @param areaMm2 Area in mm^2 (0 disables stress/modulus output)
+     */
+    void setArea(float areaMm2);
+
+    /**
+     * @brief Set specimen gauge length
+     * @param gaugeMm Gauge length in mm (0 disables strain/modulus output)
+     */
+    void setGaugeLength(float gaugeMm);
+
+    /**
+     * @brief Get configured cross-sectional area
+     * @return Area in mm^2
+     */
+    float getArea() const;
+
+    /**
+     * @brief Get configured gauge length
+     * @return Gauge length in mm
+     */
+    float getGaugeLength() const;
+
+    /**
+     * @brief Check if both area and gauge length are configured
+     * @return true if stress/strain/modulus can be computed
+     */
+    bool hasGeometry() const;
+
+    /**
+     * @brief Reset all accumulators - call at test start
+     */
+    void reset();
+
+    /**
+     * @brief Feed one recorded data point - O(1)
+     *
+     * Updates the least-squares sums for the modulus estimate and the
+     * trapezoidal energy integral.
+     *
+     * @param forceN Force in Newtons
+     * @param extensionMm Extension in mm
+     */
+    void addSample(float forceN, float extensionMm);
+
+    /**
+     * @brief Convert a force to engineering stress
+     * @param forceN Force in Newtons
+     * @return Stress in MPa (0 if no area configured)
+     */
+    float stress(float forceN) const;
+
+    /**
+     * @brief Convert an extension to engineering strain
+     * @param extensionMm Extension in mm
+     * @return Strain (dimensionless, 0 if no gauge length configured)
+     */
+    float strain(float extensionMm) const;
+
+    /**
+     * @brief Get the running elastic modulus estimate
+     *
+     * Least-squares slope of stress over strain across all samples fed
+     * since reset().
+     *
+     * @return Modulus in MPa (0 if undefined)
+     */
+    float modulus() const;
+
+    /**
+     * @brief Get energy absorbed so far (area under force-extension)
+     * @return Energy in Joules
+     */
+    float energy() const;
+
+    /**
+     * @brief Get number of samples accumulated since reset()
+     * @return Sample count
+     */
+    uint32_t sampleCount() const;
+
+private:
+    float _areaMm2;
+    float _gaugeMm;
+
+    // Least-squares accumulators: x = strain, y = stress (MPa)
+    uint32_t _n;
+    float _sumX;
+    float _sumY;
+    float _sumXY;
+    float _sumXX;
+
+    // Trapezoidal energy integral state
+    float _energyNmm;       // Accumulated area in N*mm
+    float _lastForce;
+    float _lastExtension;
+    bool _hasLast;
+};
+
+#endif // ANALYTICS_H
@@ -0,0 +1,172 @@
+#include "Capture.h"
+#include "SerialTx.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <stdio.h>
+#include <string.h>
+
+// Capture region header, stored in the first flash page of the region
+#define CAPTURE_MAGIC   0x54504143      // "CAPT"
+
+struct CaptureHeader {
+    uint32_t magic;
+    uint32_t recordCount;
+    uint32_t recordSize;
+    uint32_t reserved;
+};
+
+// Records start after the header page. Records never straddle a page:
+// 21 fit per 256-byte page and the last 4 bytes stay 0xFF, so both the
+// capacity and the replay must count whole pages, not raw bytes.
+#define CAPTURE_DATA_OFFSET     (CAPTURE_FLASH_OFFSET + FLASH_PAGE_SIZE)
+#define CAPTURE_DATA_SIZE       (CAPTURE_FLASH_SIZE - FLASH_PAGE_SIZE)
+#define CAPTURE_RECORDS_PER_PAGE (FLASH_PAGE_SIZE / sizeof(CaptureRecord))
+#define CAPTURE_DATA_PAGES      (CAPTURE_DATA_SIZE / FLASH_PAGE_SIZE)
+#define CAPTURE_MAX_RECORDS     (CAPTURE_DATA_PAGES * CAPTURE_RECORDS_PER_PAGE)
+
+// Parameter block for the flash_safe_execute callback
+struct FlashOp {
+    uint32_t offset;
+    const uint8_t* data;    // nullptr = erase
+    size_t size;
+};
+
+static void flashOpUnsafe(void* param) {
+    FlashOp* op = (FlashOp*)param;
+    if (op->data == nullptr) {
+        flash_range_erase(op->offset, op->size);
+    } else {
+        flash_range_program(op->offset, op->data, op->size);
+    }
+}
+
+static bool flashOp(uint32_t offset, const uint8_t* data, size_t size) {
+    FlashOp op = {offset, data, size};
+    return flash_safe_execute(flashOpUnsafe, &op, 100) == PICO_OK;
+}
+
+Capture::Capture()
+    : _pageFill(0)
+    , _writeOffset(0)
+    , _recordCount(0)
+    , _active(false)
+{
+    memset(_pageBuf, 0xFF, sizeof(_pageBuf));
+}
+
+bool Capture::startCapture() {
+    if (_active) return false;
+
+    // Erase sector by sector - each erase parks the machine ~45ms, so
+    // do them as separate safe-execute calls to keep interrupts (and
+    // the E-stop) live between sectors
+    for (uint32_t off = 0; off < CAPTURE_FLASH_SIZE; off += FLASH_SECTOR_SIZE) {
+        if (!flashOp(CAPTURE_FLASH_OFFSET + off, nullptr, FLASH_SECTOR_SIZE)) {
+            return false;
+        }
+    }
+
+    memset(_pageBuf, 0xFF, sizeof(_pageBuf));
+    _pageFill = 0;
+    _writeOffset = CAPTURE_DATA_OFFSET;
+    _recordCount = 0;
+    _active = true;
+    return true;
+}
+
+void Capture::record(uint32_t timestamp, int32_t rawForce, int32_t position) {
+    if (!_active) return;
+    if (_recordCount >= CAPTURE_MAX_RECORDS) return;  // Region full
+
+    CaptureRecord rec = {timestamp, rawForce, position};
+    memcpy(&_pageBuf[_pageFill], &rec, sizeof(rec));
+    _pageFill += sizeof(rec);
+    _recordCount++;
+
+    // Flush when the next record would no longer fit in the page
+    if (_pageFill + sizeof(CaptureRecord) > FLASH_PAGE_SIZE) {
+        flushPage();
+    }
+}
+
+void Capture::stopCapture() {
+    if (!_active) return;
+    _active = false;
+
+    if (_pageFill > 0) {
+        flushPage();
+    }
+
+    // Write the header page last - its presence marks a valid capture
+    uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+    CaptureHeader hdr = {CAPTURE_MAGIC, _recordCount, sizeof(CaptureRecord), 0};
+    memcpy(page, &hdr, sizeof(hdr));
+    flashOp(CAPTURE_FLASH_OFFSET, page, FLASH_PAGE_SIZE);
+}
+
+bool Capture::isActive() const {
+    return _active;
+}
+
+uint32_t Capture::recordCount() const {
+    return _recordCount;
+}
+
+void Capture::dump() {
+    // Read the header from memory-mapped flash so DUMP also works for
+    // a capture taken before the last power cycle
+    const CaptureHeader* hdr =
+        (const CaptureHeader*)(XIP_BASE + CAPTURE_FLASH_OFFSET);
+
+    if (hdr->magic != CAPTURE_MAGIC || hdr->recordSize != sizeof(CaptureRecord)) {
+        printf("CAPTURE NONE\n");
+        return;
+    }
+
+    uint32_t count = hdr->recordCount;
+    if (count > CAPTURE_MAX_RECORDS) count = CAPTURE_MAX_RECORDS;
+
+    // The replay below is blocking printf, which bypasses the TX ring -
+    // drain the ring to empty first so no half-sent frame gets bytes
+    // spliced into it in the CDC FIFO
+    while (serialTxQueued() > 0) {
+        serialTxDrain();
+    }
+
+    printf("CAPTURE START %lu\n", (unsigned long)count);
+
+    // Walk the records page by page - they are page-aligned, so a flat
+    // array read would drift by the 4 pad bytes at every page end
+    uint32_t remaining = count;
+    uint32_t pageOffset = CAPTURE_DATA_OFFSET;
+    while (remaining > 0) {
+        const CaptureRecord* records =
+            (const CaptureRecord*)(XIP_BASE + pageOffset);
+        uint32_t inPage = remaining < CAPTURE_RECORDS_PER_PAGE
+                              ? remaining : CAPTURE_RECORDS_PER_PAGE;
+        for (uint32_t i = 0; i < inPage; i++) {
+            printf("CAP %lu,%ld,%ld\n",
+                   (unsigned long)records[i].timestamp,
+                   (long)records[i].rawForce,
+                   (long)records[i].position);
+        }
+        remaining -= inPage;
+        pageOffset += FLASH_PAGE_SIZE;
+    }
+
+    printf("CAPTURE END\n");
+}
+
+void Capture::flushPage() {
+    // Belt and braces against the record-count limit: never program
+    // past the reserved region into whatever lives after it
+    if (_writeOffset + FLASH_PAGE_SIZE > CAPTURE_FLASH_OFFSET + CAPTURE_FLASH_SIZE) {
+        return;
+    }
+    flashOp(_writeOffset, _pageBuf, FLASH_PAGE_SIZE);
+    _writeOffset += FLASH_PAGE_SIZE;
+    memset(_pageBuf, 0xFF, sizeof(_pageBuf));
+    _pageFill = 0;
+}
@@ -0,0 +1,103 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include "Config.h"
+#include "Protocol.h"
+
+/**
+ * @brief One capture record - written for every ADC conversion
+ */
+struct CaptureRecord {
+    uint32_t timestamp;     // ms since test start
+    int32_t rawForce;       // Raw ADC counts (offset not removed)
+    int32_t position;       // Crosshead position in steps
+};
+
+/**
+ * @brief Full-rate test capture to onboard flash
+ *
+ * Logs every ADC sample of a test (timestamp, raw counts, position) to
+ * a reserved region of the Pico's flash in a streaming append format,
+ * so the complete stress-strain record survives USB hiccups - live
+ * streaming becomes best-effort and the flash copy is the guaranteed
+ * record. After the test, dump() replays the whole capture to the host.
+ *
+ * Records accumulate in a RAM page buffer and are programmed one
+ * 256-byte flash page at a time (~600us each, every 21 records).
+ * The capture region is erased up front in startCapture() - a few
+ * seconds before motion starts - so no sector erase ever lands in the
+ * middle of a test. Flash operations go through flash_safe_execute(),
+ * which parks core 1 for the duration.
+ *
+ * Layout: a header page (magic, record count) at the region start,
+ * written when capture stops, followed by page-aligned CaptureRecords -
+ * 21 per page, with the last 4 bytes of each page left 0xFF so no
+ * record ever straddles a page boundary.
+ */
+class Capture {
+public:
+    /**
+     * @brief Construct a new Capture object
+     */
+    Capture();
+
+    /**
+     * @brief Start a new capture - erases the capture region
+     *
+     * Blocking for a few seconds; call before test motion begins.
+     * @return true if the region was prepared
+     */
+    bool startCapture();
+
+    /**
+     * @brief Append one record - O(1), flash program every 21 records
+     * @param timestamp ms since test start
+     * @param rawForce Raw ADC counts
+     * @param position Crosshead position in steps
+     */
+    void record(uint32_t timestamp, int32_t rawForce, int32_t position);
+
+    /**
+     * @brief Stop capture - flushes the partial page and writes the header
+     */
+    void stopCapture();
+
+    /**
+     * @brief Check if capture is active
+     * @return true if capturing
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Get number of records in the current/last capture
+     * @return Record count
+     */
+    uint32_t recordCount() const;
+
+    /**
+     * @brief Replay the captured records to the host
+     *
+     * Reads straight from memory-mapped flash. Emits:
+     *   CAPTURE START <count>
+     *   CAP <timestamp>,<raw>,<position>   (one line per record)
+     *   CAPTURE END
+     *
+     * Works across power cycles via the flash header.
+     */
+    void dump();
+
+private:
+    uint8_t _pageBuf[256];      // One flash page of pending records
+    uint16_t _pageFill;         // Bytes used in _pageBuf
+    uint32_t _writeOffset;      // Next program offset (flash-relative)
+    uint32_t _recordCount;      // Records written this capture
+    bool _active;
+
+    /**
+     * @brief Program the page buffer to flash and advance
+     */
+    void flushPage();
+};
+
+#endif // CAPTURE_H
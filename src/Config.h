@@ -24,6 +24,7 @@
 #define NAU7802_SCL_PIN         9       // GP9 -> NAU7802 SCL
 #define NAU7802_I2C_ADDR        0x2A    // NAU7802 I2C address (fixed)
 #define NAU7802_I2C_FREQ        400000  // 400kHz I2C clock
+#define NAU7802_DRDY_PIN        13      // GP13 <- NAU7802 DRDY (conversion ready, active HIGH)
 
 // Limit Switch Pins (Active LOW with internal pull-up)
 #define LIMIT_SWITCH_TOP_PIN    10      // GP10 -> Top limit switch
@@ -49,8 +50,17 @@
 #define STEPPER_MICROSTEPPING   16      // Microstepping factor (set on DM542T)
 #define STEPPER_MAX_SPEED       4000    // Maximum speed (steps/sec)
 #define STEPPER_ACCELERATION    2000    // Acceleration (steps/sec²)
+#define STEPPER_JERK            40000   // Jerk limit (steps/sec³) - accel reaches full value in ACCEL/JERK s
 #define STEPPER_MM_PER_REV      8.0f    // Lead screw pitch (mm per revolution)
 
+#define STEPPER_RAMP_TABLE_SIZE 4096    // Max entries in precomputed ramp table
+
+// Two-phase homing
+#define HOMING_FAST_FRACTION    0.8f    // Fast approach speed (fraction of max)
+#define HOMING_SLOW_FRACTION    0.1f    // Precision re-touch speed (fraction of max)
+#define HOMING_BACKOFF_MM       2.0f    // Back-off distance between phases (mm)
+#define HOMING_TIMEOUT_MS       60000   // Overall homing timeout (ms)
+
 // DM542T Timing Requirements
 #define STEP_PULSE_WIDTH_US     3       // Minimum pulse width (2.5µs min for DM542T)
 #define STEP_PULSE_INTERVAL_US  3       // Minimum pulse interval
@@ -71,24 +81,71 @@
 // NAU7802 Settings
 #define NAU7802_GAIN            128     // PGA gain (1, 2, 4, 8, 16, 32, 64, 128)
 #define NAU7802_SPS             80      // Samples per second (10, 20, 40, 80, 320)
+#define HISPEED_DECIMATION      4       // Default boxcar length in HISPEED mode (320 SPS -> 80 Hz out)
 #define NAU7802_LDO_VOLTAGE     3.0f    // Internal LDO voltage (2.4, 2.7, 3.0, 3.3, 3.6, 3.9, 4.2, 4.5)
 
+// Dual-channel interleaving (second differential input, e.g. reference cell)
+#define NAU7802_CH2_INTERLEAVE  8       // Primary conversions per channel-2 visit
+#define NAU7802_CH2_SETTLE      2       // Conversions discarded after a mux switch
+
 // --- Test Parameters ---
 #define DEFAULT_SPEED_MM_S      1.0f    // Default test speed (mm/s)
 #define DEFAULT_MAX_EXTENSION   100.0f  // Default max extension (mm)
 #define DEFAULT_MAX_FORCE       450.0f  // Default max force (N) - below capacity
 #define SAMPLE_RATE_MS          50      // Data sampling rate (ms) - 20Hz
+#define PRETRIG_RING_SIZE       32      // Full-rate samples kept before a break event
+
+// Adaptive sampling defaults - all four are settable per test over the
+// protocol (EVDELTA/EVSLOPE/EVDROP/EVGAP), so one firmware covers
+// brittle specimens (dense near fracture) and elastomers (sparse
+// steady state) without a reflash
+#define EVENT_FORCE_DELTA_N     5.0f    // Force change that forces a sample (N)
+#define EVENT_SLOPE_RATIO       0.3f    // Fractional slope change that forces a sample
+#define EVENT_DROP_RATIO        0.1f    // Fractional drop from peak that forces a sample
+#define EVENT_MIN_GAP_MS        20      // Minimum spacing between event samples (ms)
+#define EVENT_DROP_FLOOR_N      50.0f   // Peak load before drop events arm (N)
+#define EVENT_SLOPE_FLOOR_N_S   1.0f    // Slope magnitude before slope events arm (N/s)
+
+// Closed-loop control modes (HOLD_FORCE / constant strain rate)
+#define HOLD_FORCE_KP           0.02f   // Velocity gain (mm/s per N of force error)
+#define HOLD_FORCE_DEADBAND_N   0.5f    // No correction inside this error band (N)
+#define STRAIN_RATE_MAX         1.0f    // Maximum strain-rate setpoint (1/s)
 
 // --- Serial Communication (USB CDC to Raspberry Pi 4) ---
 #define SERIAL_BAUD_RATE        115200  // USB Serial baud rate
 #define COMMAND_BUFFER_SIZE     128     // Command buffer size
+#define RX_RING_SIZE            256     // Bulk RX buffer (bytes)
+#define COMMAND_BATCH           4       // Max commands handled per loop pass
+#define DATA_RING_SIZE          64      // Sample ring buffer depth (packets)
+#define DATA_DRAIN_BATCH        8       // Max packets sent per drain pass
+#define TX_RING_SIZE            2048    // Non-blocking TX ring buffer (bytes)
+#define TX_RING_RESERVE         256     // Ring space kept free of droppable traffic
+#define DELTA_KEYFRAME_INTERVAL 32      // Samples between delta-mode keyframes
 
 // --- Safety Limits ---
 #define FORCE_OVERLOAD_LIMIT    480.0f  // Force overload protection (N)
 #define FORCE_OVERLOAD_PERCENT  0.96f   // 96% of load cell capacity
+#define LIMIT_DEBOUNCE_US       2000    // Limit switch release debounce (us)
 #define EXTENSION_MAX_LIMIT     150.0f  // Maximum extension limit (mm)
 #define EXTENSION_MIN_LIMIT     0.0f    // Minimum extension limit (mm)
 
+// --- Flash Test Capture ---
+// Region of onboard flash reserved for full-rate test capture.
+// Keep well clear of the firmware image at the start of flash.
+#define CAPTURE_FLASH_OFFSET    (1024 * 1024)   // 1MB into flash
+#define CAPTURE_FLASH_SIZE      (256 * 1024)    // 256KB capture region
+
+// --- Persistent Settings ---
+// One flash sector just below the capture region holding the
+// calibration/configuration block written by the SAVE command.
+#define SETTINGS_FLASH_OFFSET   (CAPTURE_FLASH_OFFSET - 4096)
+
+// --- Performance Instrumentation ---
+#define STATS_HIST_BUCKETS      12      // Power-of-two us buckets (1us .. 2ms+)
+
+// --- Cooperative Scheduler ---
+#define SCHED_MAX_TASKS         8       // Task table capacity
+
 // --- Timing ---
 #define DEBOUNCE_DELAY_MS       50      // Button debounce delay
 #define EMERGENCY_CHECK_MS      10      // Emergency stop check interval
@@ -0,0 +1,43 @@
+#include "GpioIrq.h"
+
+// Registered handlers, searched linearly in the ISR. The table is tiny
+// (DRDY, two limit switches, E-stop) so a scan costs a few cycles.
+#define GPIO_IRQ_MAX_HANDLERS   8
+
+struct GpioIrqEntry {
+    uint8_t pin;
+    GpioIrqHandler handler;
+};
+
+static GpioIrqEntry s_handlers[GPIO_IRQ_MAX_HANDLERS];
+static uint8_t s_handlerCount = 0;
+static bool s_callbackInstalled = false;
+
+// Shared GPIO ISR - dispatches to the handler registered for the pin
+static void gpioIrqDispatch(uint gpio, uint32_t events) {
+    for (uint8_t i = 0; i < s_handlerCount; i++) {
+        if (s_handlers[i].pin == gpio) {
+            s_handlers[i].handler(gpio, events);
+            return;
+        }
+    }
+}
+
+bool gpioIrqRegister(uint8_t pin, uint32_t events, GpioIrqHandler handler) {
+    if (s_handlerCount >= GPIO_IRQ_MAX_HANDLERS) {
+        return false;
+    }
+
+    s_handlers[s_handlerCount].pin = pin;
+    s_handlers[s_handlerCount].handler = handler;
+    s_handlerCount++;
+
+    if (!s_callbackInstalled) {
+        gpio_set_irq_enabled_with_callback(pin, events, true, gpioIrqDispatch);
+        s_callbackInstalled = true;
+    } else {
+        gpio_set_irq_enabled(pin, events, true);
+    }
+
+    return true;
+}
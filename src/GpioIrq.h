@@ -0,0 +1,30 @@
+#ifndef GPIOIRQ_H
+#define GPIOIRQ_H
+
+#include <stdint.h>
+#include "hardware/gpio.h"
+
+/**
+ * @brief Handler signature for a registered GPIO interrupt
+ * @param gpio Pin that raised the interrupt
+ * @param events Edge/level event mask (GPIO_IRQ_*)
+ */
+typedef void (*GpioIrqHandler)(uint gpio, uint32_t events);
+
+/**
+ * @brief Register a per-pin GPIO interrupt handler
+ *
+ * The RP2040 SDK allows only one GPIO callback per core, so every
+ * module that needs an edge interrupt (load cell DRDY, limit switches,
+ * E-stop) registers here and this dispatcher routes events by pin.
+ * Callers configure the pin (direction, pulls) themselves; this only
+ * installs the handler and enables the interrupt.
+ *
+ * @param pin GPIO pin number
+ * @param events Event mask to enable (GPIO_IRQ_EDGE_RISE etc.)
+ * @param handler Function called from the ISR for this pin
+ * @return true if registered, false if the handler table is full
+ */
+bool gpioIrqRegister(uint8_t pin, uint32_t events, GpioIrqHandler handler);
+
+#endif // GPIOIRQ_H
@@ -1,6 +1,93 @@
 #include "LoadCell.h"
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/gpio.h"
+#include "hardware/dma.h"
+#include "GpioIrq.h"
+#include "Stats.h"
+
+// DRDY interrupt flag - set in the GPIO ISR, cleared when the sample is
+// fetched. Single-byte flag, atomic on the RP2040.
+static volatile bool s_dataReady = false;
+
+// GPIO IRQ handler for the NAU7802 DRDY edge, registered with the
+// shared GpioIrq dispatcher. The actual I2C read happens in thread
+// context (fetchConversion) - ISRs must not touch the bus while a
+// foreground transaction may be in flight.
+static void drdyIrqHandler(uint gpio, uint32_t events) {
+    (void)gpio;
+    if (events & GPIO_IRQ_EDGE_RISE) {
+        s_dataReady = true;
+    }
+}
+
+// --- DMA-driven sample readout ---------------------------------------------
+//
+// The 3-byte result read is driven entirely by two chained DMA channels:
+// a TX channel feeds command words (register address, then three read
+// commands, last one with STOP) into IC_DATA_CMD, and an RX channel
+// drains the received bytes into s_dmaSample. The CPU only arms the
+// transfer when DRDY fires and picks the bytes up once the RX channel
+// reports done - no i2c_*_blocking call holds the core for the ~100us
+// the transaction takes on the wire.
+
+#define I2C_CMD_READ    0x0100u     // IC_DATA_CMD: read command
+#define I2C_CMD_STOP    0x0200u     // IC_DATA_CMD: issue STOP after byte
+#define I2C_CMD_RESTART 0x0400u     // IC_DATA_CMD: issue RESTART before byte
+
+static int s_i2cTxDma = -1;
+static int s_i2cRxDma = -1;
+
+// Command sequence: write register pointer, repeated-start into three reads
+static const uint16_t s_dmaCommands[4] = {
+    NAU7802_REG_ADCO_B2,
+    I2C_CMD_RESTART | I2C_CMD_READ,
+    I2C_CMD_READ,
+    I2C_CMD_READ | I2C_CMD_STOP,
+};
+
+static uint8_t s_dmaSample[3];
+static volatile bool s_dmaInFlight = false;
+
+static bool i2cDmaInit() {
+    s_i2cTxDma = dma_claim_unused_channel(false);
+    s_i2cRxDma = dma_claim_unused_channel(false);
+    if (s_i2cTxDma < 0 || s_i2cRxDma < 0) {
+        return false;
+    }
+
+    i2c_hw_t* hw = i2c_get_hw(NAU7802_I2C_PORT);
+
+    dma_channel_config tx = dma_channel_get_default_config(s_i2cTxDma);
+    channel_config_set_transfer_data_size(&tx, DMA_SIZE_16);
+    channel_config_set_read_increment(&tx, true);
+    channel_config_set_write_increment(&tx, false);
+    channel_config_set_dreq(&tx, i2c_get_dreq(NAU7802_I2C_PORT, true));
+    dma_channel_configure(s_i2cTxDma, &tx, &hw->data_cmd, s_dmaCommands, 4, false);
+
+    // RX reads the LSB of IC_DATA_CMD - an 8-bit DMA read of the
+    // register address picks up just the data byte
+    dma_channel_config rx = dma_channel_get_default_config(s_i2cRxDma);
+    channel_config_set_transfer_data_size(&rx, DMA_SIZE_8);
+    channel_config_set_read_increment(&rx, false);
+    channel_config_set_write_increment(&rx, true);
+    channel_config_set_dreq(&rx, i2c_get_dreq(NAU7802_I2C_PORT, false));
+    dma_channel_configure(s_i2cRxDma, &rx, s_dmaSample, &hw->data_cmd, 3, false);
+
+    return true;
+}
+
+static void i2cDmaStartRead() {
+    dma_channel_set_write_addr(s_i2cRxDma, s_dmaSample, false);
+    dma_channel_set_trans_count(s_i2cRxDma, 3, true);
+    dma_channel_set_read_addr(s_i2cTxDma, s_dmaCommands, false);
+    dma_channel_set_trans_count(s_i2cTxDma, 4, true);
+    s_dmaInFlight = true;
+}
+
+static bool i2cDmaReadDone() {
+    return s_dmaInFlight && !dma_channel_is_busy(s_i2cRxDma);
+}
 
 LoadCell::LoadCell(uint8_t sdaPin, uint8_t sclPin)
     : _sdaPin(sdaPin)
@@ -8,11 +95,43 @@ LoadCell::LoadCell(uint8_t sdaPin, uint8_t sclPin)
     , _calibrationFactor(LOADCELL_CALIBRATION)
     , _offset(LOADCELL_OFFSET)
     , _lastForce(0.0f)
+    , _forceDirty(false)
+    , _lastRaw(0)
+    , _sampleCount(0)
+    , _overloadRawHi(0)
+    , _overloadRawLo(0)
     , _initialized(false)
+    , _interruptMode(false)
+    , _dmaReadout(false)
+    , _dualChannel(false)
+    , _activeChannel(0)
+    , _chSettleLeft(0)
+    , _chPrimaryDone(0)
+    , _offset2(0)
+    , _calibrationFactor2(LOADCELL_CALIBRATION)
+    , _lastRaw2(0)
+    , _lastForce2(0.0f)
+    , _forceDirty2(false)
+    , _sampleCount2(0)
+    , _hispeedMode(false)
+    , _decimation(1)
+    , _filterSum(0)
+    , _filterCount(0)
+    , _asyncOp(AsyncOp::NONE)
+    , _asyncTarget(0)
+    , _asyncCount(0)
+    , _asyncSum(0)
+    , _asyncResultRaw(0)
+    , _afeCalibrating(false)
+    , _afeCalOk(false)
+    , _startupTareDone(false)
+    , _afeCalStartMs(0)
+    , _afeLastPollMs(0)
 {
+    updateRawThresholds();
 }
 
-bool LoadCell::begin() {
+bool LoadCell::begin(bool startAfeCal) {
     // Initialize I2C
     i2c_init(NAU7802_I2C_PORT, NAU7802_I2C_FREQ);
     gpio_set_function(_sdaPin, GPIO_FUNC_I2C);
@@ -68,34 +187,323 @@ bool LoadCell::begin() {
     pga |= 0x80;  // Set LDOMODE bit for better stability
     writeRegister(NAU7802_REG_PGA, pga);
     
-    // Perform internal calibration
-    if (!calibrateAFE()) {
-        return false;
-    }
-    
-    // Start conversions
-    if (!setBit(NAU7802_REG_PU_CTRL, NAU7802_PU_CTRL_CS)) {
-        return false;
+    // Kick off internal calibration but do not wait for it - the CALS
+    // bit is polled from readForce() and conversions plus the startup
+    // tare follow once it clears. Cold start to command processing is
+    // register-config time (~10ms) instead of seconds. Skipped when the
+    // caller restores a persisted calibration instead.
+    if (startAfeCal) {
+        uint8_t ctrl2 = readRegister(NAU7802_REG_CTRL2);
+        ctrl2 |= NAU7802_CTRL2_CALS;
+        writeRegister(NAU7802_REG_CTRL2, ctrl2);
+
+        _afeCalibrating = true;
+        _afeCalStartMs = to_ms_since_boot(get_absolute_time());
+        _afeLastPollMs = _afeCalStartMs;
     }
-    
-    // Wait for first conversion
-    sleep_ms(100);
-    
-    // Perform initial tare
-    tare(20);
-    
+
     _initialized = true;
     return true;
 }
 
+void LoadCell::pollAfeCalibration() {
+    // One register read per 10ms at most - calibration takes tens of ms
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if ((now - _afeLastPollMs) < 10) {
+        return;
+    }
+    _afeLastPollMs = now;
+
+    uint8_t ctrl2 = readRegister(NAU7802_REG_CTRL2);
+    bool done = !(ctrl2 & 0x04);                    // CALS cleared
+    bool timedOut = (now - _afeCalStartMs) >= 2000;
+
+    if (!done && !timedOut) {
+        return;
+    }
+
+    _afeCalOk = done && !(ctrl2 & 0x08);            // CAL_ERR bit
+    _afeCalibrating = false;
+
+    // Start conversions and replace the old blocking tare(20) with an
+    // async one fed by the normal sample stream
+    setBit(NAU7802_REG_PU_CTRL, NAU7802_PU_CTRL_CS);
+    tareAsync(20);
+}
+
+bool LoadCell::startupComplete() const {
+    return _initialized && !_afeCalibrating && _startupTareDone;
+}
+
+bool LoadCell::afeCalibrationOk() const {
+    return _afeCalOk;
+}
+
+void LoadCell::enableDataReadyInterrupt(uint8_t drdyPin) {
+    gpio_init(drdyPin);
+    gpio_set_dir(drdyPin, GPIO_IN);
+    gpio_pull_down(drdyPin);  // DRDY is active HIGH (CRP=0 default)
+
+    gpioIrqRegister(drdyPin, GPIO_IRQ_EDGE_RISE, drdyIrqHandler);
+
+    // If a conversion completed before the IRQ was armed, pick it up
+    s_dataReady = gpio_get(drdyPin);
+
+    // Sample readout goes through chained DMA when channels are free;
+    // falls back to short blocking reads otherwise
+    _dmaReadout = i2cDmaInit();
+
+    _interruptMode = true;
+}
+
+bool LoadCell::hasNewSample() const {
+    return s_dataReady;
+}
+
 float LoadCell::readForce() {
     if (!_initialized) {
         return 0.0f;
     }
-    
-    int32_t raw = readRaw();
-    _lastForce = (float)(raw - _offset) / _calibrationFactor;
-    return _lastForce;
+
+    // Drive the background AFE calibration until conversions start
+    if (_afeCalibrating) {
+        pollAfeCalibration();
+        return getLastForce();
+    }
+
+    if (_interruptMode && _dmaReadout) {
+        // Fully asynchronous: collect a finished DMA readout if one
+        // landed, then arm the next one when DRDY fires. The CPU never
+        // waits on the bus.
+        if (i2cDmaReadDone()) {
+            s_dmaInFlight = false;
+            int32_t value = ((uint32_t)s_dmaSample[0] << 16) |
+                            ((uint32_t)s_dmaSample[1] << 8) |
+                            s_dmaSample[2];
+            if (value & 0x800000) {
+                value |= 0xFF000000;
+            }
+            ingestSample(value);
+        }
+        if (s_dataReady && !s_dmaInFlight) {
+            s_dataReady = false;
+            i2cDmaStartRead();
+        }
+        return getLastForce();
+    } else if (_interruptMode) {
+        // Non-blocking: fetch only if DRDY has fired, otherwise keep
+        // returning the latest completed conversion
+        if (!s_dataReady) {
+            return getLastForce();
+        }
+        ingestSample(fetchConversion());
+    } else {
+        ingestSample(readRaw());
+    }
+
+    return getLastForce();
+}
+
+void LoadCell::ingestSample(int32_t raw) {
+    // Post-switch settling: the PGA needs a few conversions on the new
+    // input before results are trustworthy - drop them on the floor
+    if (_chSettleLeft > 0) {
+        _chSettleLeft--;
+        return;
+    }
+
+    if (!_dualChannel || _activeChannel == 0) {
+        applySample(raw);
+        if (_dualChannel && ++_chPrimaryDone >= NAU7802_CH2_INTERLEAVE) {
+            switchChannel(1);
+        }
+        return;
+    }
+
+    // One channel-2 sample per visit, then straight back to primary
+    _lastRaw2 = raw;
+    _forceDirty2 = true;
+    _sampleCount2++;
+    switchChannel(0);
+}
+
+void LoadCell::switchChannel(uint8_t channel) {
+    // One short register transaction per interleave boundary - the
+    // conversion pipeline keeps running across the switch, so the only
+    // per-channel cost is the discarded settling conversions
+    if (channel != 0) {
+        setBit(NAU7802_REG_CTRL2, NAU7802_CTRL2_CHS);
+    } else {
+        clearBit(NAU7802_REG_CTRL2, NAU7802_CTRL2_CHS);
+    }
+    _activeChannel = channel;
+    _chSettleLeft = NAU7802_CH2_SETTLE;
+    _chPrimaryDone = 0;
+}
+
+void LoadCell::setDualChannelMode(bool enable) {
+    if (enable == _dualChannel) {
+        return;
+    }
+    _dualChannel = enable;
+    _chPrimaryDone = 0;
+    if (_activeChannel != 0) {
+        switchChannel(0);
+    }
+}
+
+bool LoadCell::isDualChannelMode() const {
+    return _dualChannel;
+}
+
+float LoadCell::getSecondaryForce() const {
+    if (_forceDirty2) {
+        _lastForce2 = (float)(_lastRaw2 - _offset2) / _calibrationFactor2;
+        _forceDirty2 = false;
+    }
+    return _lastForce2;
+}
+
+int32_t LoadCell::getSecondaryRaw() const {
+    return _lastRaw2;
+}
+
+uint32_t LoadCell::getSecondarySampleCount() const {
+    return _sampleCount2;
+}
+
+void LoadCell::setSecondaryCalibrationFactor(float factor) {
+    if (factor != 0.0f) {
+        _calibrationFactor2 = factor;
+        _forceDirty2 = true;
+    }
+}
+
+float LoadCell::getSecondaryCalibrationFactor() const {
+    return _calibrationFactor2;
+}
+
+void LoadCell::setSecondaryOffset(int32_t offset) {
+    _offset2 = offset;
+    _forceDirty2 = true;
+}
+
+int32_t LoadCell::getSecondaryOffset() const {
+    return _offset2;
+}
+
+void LoadCell::tareSecondary() {
+    _offset2 = _lastRaw2;
+    _forceDirty2 = true;
+}
+
+void LoadCell::getAfeCalibration(uint8_t ocal[3], uint8_t gcal[4]) {
+    ocal[0] = readRegister(NAU7802_REG_OCAL1_B2);
+    ocal[1] = readRegister(NAU7802_REG_OCAL1_B1);
+    ocal[2] = readRegister(NAU7802_REG_OCAL1_B0);
+    gcal[0] = readRegister(NAU7802_REG_GCAL1_B3);
+    gcal[1] = readRegister(NAU7802_REG_GCAL1_B2);
+    gcal[2] = readRegister(NAU7802_REG_GCAL1_B1);
+    gcal[3] = readRegister(NAU7802_REG_GCAL1_B0);
+}
+
+void LoadCell::restoreAfeCalibration(const uint8_t ocal[3], const uint8_t gcal[4]) {
+    writeRegister(NAU7802_REG_OCAL1_B2, ocal[0]);
+    writeRegister(NAU7802_REG_OCAL1_B1, ocal[1]);
+    writeRegister(NAU7802_REG_OCAL1_B0, ocal[2]);
+    writeRegister(NAU7802_REG_GCAL1_B3, gcal[0]);
+    writeRegister(NAU7802_REG_GCAL1_B2, gcal[1]);
+    writeRegister(NAU7802_REG_GCAL1_B1, gcal[2]);
+    writeRegister(NAU7802_REG_GCAL1_B0, gcal[3]);
+
+    // Start conversions - no calibration cycle, no startup tare; the
+    // persisted offset already zeroes the cell
+    setBit(NAU7802_REG_PU_CTRL, NAU7802_PU_CTRL_CS);
+    _afeCalibrating = false;
+    _afeCalOk = true;
+    _startupTareDone = true;
+}
+
+void LoadCell::applySample(int32_t raw) {
+    // Integer-only hot path: cache the raw value and mark the float
+    // conversion stale - getLastForce() converts on demand
+    if (!_hispeedMode || _decimation <= 1) {
+        _lastRaw = raw;
+        _forceDirty = true;
+        _sampleCount++;
+        if (_asyncOp != AsyncOp::NONE) {
+            accumulateAsync(raw);
+        }
+        return;
+    }
+
+    // Boxcar decimation: accumulate, emit the average once per window
+    _filterSum += raw;
+    _filterCount++;
+    if (_filterCount >= _decimation) {
+        _lastRaw = (int32_t)(_filterSum / _filterCount);
+        _filterSum = 0;
+        _filterCount = 0;
+        _forceDirty = true;
+        _sampleCount++;
+        if (_asyncOp != AsyncOp::NONE) {
+            accumulateAsync(_lastRaw);
+        }
+    }
+}
+
+void LoadCell::accumulateAsync(int32_t raw) {
+    _asyncSum += raw;
+    _asyncCount++;
+    if (_asyncCount < _asyncTarget) {
+        return;
+    }
+
+    _asyncResultRaw = (int32_t)(_asyncSum / _asyncCount);
+    if (_asyncOp == AsyncOp::TARE) {
+        _offset = _asyncResultRaw;
+        updateRawThresholds();
+        _startupTareDone = true;    // First completed tare settles startup
+    }
+    _asyncOp = AsyncOp::NONE;
+}
+
+void LoadCell::setHighSpeedMode(bool enable, uint8_t decimation) {
+    if (decimation < 1) decimation = 1;
+    if (decimation > 32) decimation = 32;
+
+    _hispeedMode = enable;
+    _decimation = enable ? decimation : 1;
+    _filterSum = 0;
+    _filterCount = 0;
+
+    setSampleRate(enable ? NAU7802SPS::SPS_320 : NAU7802SPS::SPS_80);
+}
+
+bool LoadCell::isHighSpeedMode() const {
+    return _hispeedMode;
+}
+
+int32_t LoadCell::fetchConversion() {
+    s_dataReady = false;
+
+    // Read 24-bit ADC value - single short transaction, no polling
+    uint8_t data[3];
+    uint8_t reg = NAU7802_REG_ADCO_B2;
+
+    uint32_t t0 = time_us_32();
+    i2c_write_blocking(NAU7802_I2C_PORT, NAU7802_I2C_ADDR, &reg, 1, true);
+    i2c_read_blocking(NAU7802_I2C_PORT, NAU7802_I2C_ADDR, data, 3, false);
+    statsRecord(StatChannel::I2C, time_us_32() - t0);
+
+    int32_t value = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    if (value & 0x800000) {
+        value |= 0xFF000000;
+    }
+
+    // The cached raw belongs to whichever channel ingestSample() routes
+    // this to - do not touch _lastRaw here
+    return value;
 }
 
 int32_t LoadCell::readRaw() {
@@ -122,7 +530,8 @@ int32_t LoadCell::readRaw() {
     if (value & 0x800000) {
         value |= 0xFF000000;
     }
-    
+
+    _lastRaw = value;
     return value;
 }
 
@@ -165,12 +574,48 @@ void LoadCell::tare(uint8_t samples) {
     
     if (validSamples > 0) {
         _offset = sum / validSamples;
+        updateRawThresholds();
+    }
+}
+
+bool LoadCell::tareAsync(uint8_t samples) {
+    if (_asyncOp != AsyncOp::NONE) {
+        return false;
     }
+    if (samples == 0) samples = 1;
+
+    _asyncOp = AsyncOp::TARE;
+    _asyncTarget = samples;
+    _asyncCount = 0;
+    _asyncSum = 0;
+    return true;
+}
+
+bool LoadCell::averageAsync(uint8_t samples) {
+    if (_asyncOp != AsyncOp::NONE) {
+        return false;
+    }
+    if (samples == 0) samples = 1;
+
+    _asyncOp = AsyncOp::AVERAGE;
+    _asyncTarget = samples;
+    _asyncCount = 0;
+    _asyncSum = 0;
+    return true;
+}
+
+bool LoadCell::isAsyncBusy() const {
+    return _asyncOp != AsyncOp::NONE;
+}
+
+float LoadCell::getAverageForce() const {
+    return rawToNewtons(_asyncResultRaw);
 }
 
 void LoadCell::setCalibrationFactor(float factor) {
     if (factor != 0.0f) {
         _calibrationFactor = factor;
+        updateRawThresholds();
     }
 }
 
@@ -180,6 +625,7 @@ float LoadCell::getCalibrationFactor() const {
 
 void LoadCell::setOffset(int32_t offset) {
     _offset = offset;
+    updateRawThresholds();
 }
 
 int32_t LoadCell::getOffset() const {
@@ -192,14 +638,45 @@ bool LoadCell::isReady() {
 }
 
 bool LoadCell::isOverload() {
-    float absForce = _lastForce > 0 ? _lastForce : -_lastForce;
-    return absForce > FORCE_OVERLOAD_LIMIT;
+    // Pure integer compare against precomputed raw-count thresholds -
+    // no float math on the per-sample safety path
+    return _lastRaw > _overloadRawHi || _lastRaw < _overloadRawLo;
 }
 
 float LoadCell::getLastForce() const {
+    if (_forceDirty) {
+        _lastForce = (float)(_lastRaw - _offset) / _calibrationFactor;
+        _forceDirty = false;
+    }
     return _lastForce;
 }
 
+int32_t LoadCell::getLastRaw() const {
+    return _lastRaw;
+}
+
+uint32_t LoadCell::getSampleCount() const {
+    return _sampleCount;
+}
+
+int32_t LoadCell::newtonsToRaw(float newtons) const {
+    return _offset + (int32_t)(newtons * _calibrationFactor);
+}
+
+int32_t LoadCell::newtonsToRawDelta(float newtons) const {
+    return (int32_t)(newtons * _calibrationFactor);
+}
+
+float LoadCell::rawToNewtons(int32_t raw) const {
+    return (float)(raw - _offset) / _calibrationFactor;
+}
+
+void LoadCell::updateRawThresholds() {
+    _overloadRawHi = newtonsToRaw(FORCE_OVERLOAD_LIMIT);
+    _overloadRawLo = newtonsToRaw(-FORCE_OVERLOAD_LIMIT);
+    _forceDirty = true;
+}
+
 void LoadCell::setGain(NAU7802Gain gain) {
     uint8_t ctrl1 = readRegister(NAU7802_REG_CTRL1);
     ctrl1 &= 0xF8;  // Clear gain bits [2:0]
@@ -254,13 +731,32 @@ void LoadCell::powerUp() {
     setBit(NAU7802_REG_PU_CTRL, NAU7802_PU_CTRL_CS);
 }
 
+void LoadCell::dmaQuiesce() {
+    // Only the command-driven paths (HISPEED, DUAL, TARE...) can land
+    // here mid-read - ingestSample() runs between completion and
+    // re-arm, and nothing re-arms until the next readForce()
+    if (!_dmaReadout || !s_dmaInFlight) {
+        return;
+    }
+    uint32_t t0 = time_us_32();
+    while (dma_channel_is_busy(s_i2cRxDma)) {
+        // Wedged bus: give up and let the blocking call fail loudly
+        if (time_us_32() - t0 > 1000) {
+            break;
+        }
+        tight_loop_contents();
+    }
+}
+
 bool LoadCell::writeRegister(uint8_t reg, uint8_t value) {
+    dmaQuiesce();
     uint8_t data[2] = {reg, value};
     int result = i2c_write_blocking(NAU7802_I2C_PORT, NAU7802_I2C_ADDR, data, 2, false);
     return result == 2;
 }
 
 uint8_t LoadCell::readRegister(uint8_t reg) {
+    dmaQuiesce();
     uint8_t value;
     i2c_write_blocking(NAU7802_I2C_PORT, NAU7802_I2C_ADDR, &reg, 1, true);
     i2c_read_blocking(NAU7802_I2C_PORT, NAU7802_I2C_ADDR, &value, 1, false);
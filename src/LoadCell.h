@@ -24,6 +24,11 @@
 #define NAU7802_REG_PWR_CTRL    0x1C    // Power control
 #define NAU7802_REG_REVISION    0x1F    // Revision ID
 
+// NAU7802 CTRL2 Register Bits
+#define NAU7802_CTRL2_CHS       0x80    // Channel select (0=ch1, 1=ch2)
+#define NAU7802_CTRL2_CALS      0x04    // Start/in-progress AFE calibration
+#define NAU7802_CTRL2_CAL_ERR   0x08    // Calibration error flag
+
 // NAU7802 PU_CTRL Register Bits
 #define NAU7802_PU_CTRL_RR      0x01    // Register reset
 #define NAU7802_PU_CTRL_PUD     0x02    // Power up digital
@@ -84,12 +89,42 @@ public:
 
     /**
      * @brief Initialize the NAU7802 ADC
+     *
+     * When startAfeCal is false the internal AFE calibration is not
+     * started - the caller is expected to restore persisted calibration
+     * registers via restoreAfeCalibration(), which also starts
+     * conversions. Used at boot when a valid settings block exists.
+     *
+     * @param startAfeCal true to kick off the async AFE calibration
      * @return true if initialization successful
      */
-    bool begin();
+    bool begin(bool startAfeCal = true);
+
+    /**
+     * @brief Enable interrupt-driven acquisition from the DRDY pin
+     *
+     * Wires the NAU7802 conversion-ready output to a GPIO edge
+     * interrupt. Once enabled, readForce() becomes a non-blocking fetch
+     * of the latest completed conversion instead of a polled wait -
+     * no more isReady() register reads or sleep_ms(1) loops per sample.
+     *
+     * @param drdyPin GPIO connected to the NAU7802 DRDY output
+     */
+    void enableDataReadyInterrupt(uint8_t drdyPin = NAU7802_DRDY_PIN);
+
+    /**
+     * @brief Check if a completed conversion is waiting to be fetched
+     * @return true if a new sample is available
+     */
+    bool hasNewSample() const;
 
     /**
      * @brief Read current force value
+     *
+     * In interrupt mode this fetches the latest completed conversion
+     * (one short I2C read, only when DRDY has fired) and never blocks.
+     * Without the interrupt it falls back to the polled readRaw() path.
+     *
      * @return Force in Newtons
      */
     float readForce();
@@ -109,10 +144,50 @@ public:
 
     /**
      * @brief Tare the load cell (set current reading as zero)
+     *
+     * Blocks while the samples accumulate (~125ms at 80 SPS) - fine
+     * during begin(), but runtime tares should use tareAsync().
+     *
      * @param samples Number of samples for tare averaging
      */
     void tare(uint8_t samples = LOADCELL_SAMPLES);
 
+    /**
+     * @brief Start an asynchronous tare
+     *
+     * Accumulation happens sample-by-sample inside readForce() as
+     * conversions arrive - nothing blocks. Poll isAsyncBusy() for
+     * completion; the offset is applied when the last sample lands.
+     *
+     * @param samples Number of samples to average into the offset
+     * @return false if another async operation is already running
+     */
+    bool tareAsync(uint8_t samples = LOADCELL_SAMPLES);
+
+    /**
+     * @brief Start an asynchronous force average
+     *
+     * Non-blocking counterpart to readForceAverage(): accumulates as
+     * conversions arrive, result available from getAverageForce() once
+     * isAsyncBusy() returns false.
+     *
+     * @param samples Number of samples to average
+     * @return false if another async operation is already running
+     */
+    bool averageAsync(uint8_t samples = LOADCELL_SAMPLES);
+
+    /**
+     * @brief Check if an async tare/average is still accumulating
+     * @return true while samples are being collected
+     */
+    bool isAsyncBusy() const;
+
+    /**
+     * @brief Get the result of the last completed averageAsync()
+     * @return Averaged force in Newtons
+     */
+    float getAverageForce() const;
+
     /**
      * @brief Set calibration factor
      * @param factor Calibration factor (raw units per Newton)
@@ -151,10 +226,57 @@ public:
 
     /**
      * @brief Get the last read force value (cached)
+     *
+     * Converts from raw counts lazily - the hot acquisition path only
+     * touches integers, and the soft-float divide happens here, at the
+     * protocol/reporting boundary, once per query instead of per sample.
+     *
      * @return Last force value in Newtons
      */
     float getLastForce() const;
 
+    /**
+     * @brief Get the last raw ADC value (cached, offset NOT removed)
+     * @return Last raw counts
+     */
+    int32_t getLastRaw() const;
+
+    /**
+     * @brief Get the number of samples emitted since power-up
+     *
+     * Increments once per output sample (per decimation window in
+     * HISPEED mode). Lets callers detect new samples without extra
+     * I2C traffic.
+     *
+     * @return Sample counter
+     */
+    uint32_t getSampleCount() const;
+
+    /**
+     * @brief Convert a force to absolute raw counts (offset included)
+     *
+     * Used to precompute integer thresholds so hot-path comparisons
+     * (overload, force limit, break detection) stay fixed-point.
+     *
+     * @param newtons Force in Newtons
+     * @return Equivalent raw ADC counts
+     */
+    int32_t newtonsToRaw(float newtons) const;
+
+    /**
+     * @brief Convert a force delta to raw count delta (no offset)
+     * @param newtons Force delta in Newtons
+     * @return Equivalent raw count delta
+     */
+    int32_t newtonsToRawDelta(float newtons) const;
+
+    /**
+     * @brief Convert raw counts to Newtons (offset removed)
+     * @param raw Raw ADC counts
+     * @return Force in Newtons
+     */
+    float rawToNewtons(int32_t raw) const;
+
     /**
      * @brief Set PGA gain
      * @param gain Gain setting (1-128)
@@ -167,12 +289,149 @@ public:
      */
     void setSampleRate(NAU7802SPS sps);
 
+    /**
+     * @brief Enable/disable 320 SPS high-speed acquisition
+     *
+     * Programs the ADC to SPS_320 and runs a boxcar decimation filter
+     * over the raw stream: every `decimation` conversions are averaged
+     * into one output sample. Compared to readForceAverage() this gets
+     * the same noise reduction with zero blocking - the filter is fed
+     * as conversions arrive. decimation=4 gives filtered 80 Hz output
+     * with a quarter of the latency of a 10-sample blocking average.
+     *
+     * @param enable true for 320 SPS + decimation, false for NAU7802_SPS
+     * @param decimation Boxcar length (1-32)
+     */
+    void setHighSpeedMode(bool enable, uint8_t decimation = HISPEED_DECIMATION);
+
+    /**
+     * @brief Check if high-speed acquisition is active
+     * @return true if in HISPEED mode
+     */
+    bool isHighSpeedMode() const;
+
+    /**
+     * @brief Enable/disable interleaved dual-channel acquisition
+     *
+     * The NAU7802 has a second differential input (ch2, typically a
+     * small reference cell for compliance correction). When enabled, a
+     * channel-switching scheduler rides on the normal conversion
+     * stream: every NAU7802_CH2_INTERLEAVE primary conversions the CHS
+     * bit is flipped, the next NAU7802_CH2_SETTLE conversions are
+     * discarded while the PGA settles on the new input, one secondary
+     * sample is taken, and the mux switches straight back. Everything
+     * happens as conversions arrive - the switch itself is one short
+     * register write and nothing ever blocks waiting for settling.
+     *
+     * @param enable true to interleave channel 2 into the stream
+     */
+    void setDualChannelMode(bool enable);
+
+    /**
+     * @brief Check if dual-channel acquisition is active
+     * @return true if channel 2 is being interleaved
+     */
+    bool isDualChannelMode() const;
+
+    /**
+     * @brief Get the last channel-2 force value (cached)
+     *
+     * Converted lazily from raw counts with the channel-2 offset and
+     * calibration factor, same scheme as getLastForce().
+     *
+     * @return Last channel-2 force in Newtons
+     */
+    float getSecondaryForce() const;
+
+    /**
+     * @brief Get the last raw channel-2 ADC value (offset NOT removed)
+     * @return Last channel-2 raw counts
+     */
+    int32_t getSecondaryRaw() const;
+
+    /**
+     * @brief Get the number of channel-2 samples since power-up
+     * @return Channel-2 sample counter
+     */
+    uint32_t getSecondarySampleCount() const;
+
+    /**
+     * @brief Set channel-2 calibration factor
+     * @param factor Calibration factor (raw units per Newton)
+     */
+    void setSecondaryCalibrationFactor(float factor);
+
+    /**
+     * @brief Get channel-2 calibration factor
+     * @return Calibration factor (raw units per Newton)
+     */
+    float getSecondaryCalibrationFactor() const;
+
+    /**
+     * @brief Set channel-2 zero offset
+     * @param offset Zero offset value
+     */
+    void setSecondaryOffset(int32_t offset);
+
+    /**
+     * @brief Get channel-2 zero offset
+     * @return Current channel-2 offset
+     */
+    int32_t getSecondaryOffset() const;
+
+    /**
+     * @brief Zero channel 2 at its current reading
+     */
+    void tareSecondary();
+
+    /**
+     * @brief Read the AFE calibration registers (for persistence)
+     *
+     * Only meaningful after a successful calibration - check
+     * afeCalibrationOk() first.
+     *
+     * @param ocal Receives OCAL1_B2..B0
+     * @param gcal Receives GCAL1_B3..B0
+     */
+    void getAfeCalibration(uint8_t ocal[3], uint8_t gcal[4]);
+
+    /**
+     * @brief Restore persisted AFE calibration and start conversions
+     *
+     * Writes the saved OCAL/GCAL registers, starts the conversion
+     * cycle and marks the startup sequence settled - the persisted
+     * offset replaces the startup tare, so the machine is test-ready
+     * without the calibration/tare ceremony. Pair with
+     * begin(false).
+     *
+     * @param ocal Saved OCAL1_B2..B0
+     * @param gcal Saved GCAL1_B3..B0
+     */
+    void restoreAfeCalibration(const uint8_t ocal[3], const uint8_t gcal[4]);
+
     /**
      * @brief Perform internal calibration
      * @return true if calibration successful
      */
     bool calibrateAFE();
 
+    /**
+     * @brief Check if the startup sequence has fully settled
+     *
+     * begin() returns after register configuration (~10ms); AFE
+     * calibration and the initial tare complete in the background as
+     * readForce() is called. This reports when both have finished.
+     *
+     * @return true once calibration and the startup tare are done
+     */
+    bool startupComplete() const;
+
+    /**
+     * @brief Check if the background AFE calibration succeeded
+     * @return true if calibration completed without error
+     */
+    bool afeCalibrationOk() const;
+
     /**
      * @brief Get revision ID of NAU7802
      * @return Revision ID
@@ -194,8 +453,125 @@ private:
     uint8_t _sclPin;
     float _calibrationFactor;
     int32_t _offset;
-    float _lastForce;
+    mutable float _lastForce;       // Converted lazily in getLastForce()
+    mutable bool _forceDirty;       // _lastRaw newer than _lastForce
+    int32_t _lastRaw;
+    uint32_t _sampleCount;          // Output samples since power-up
+    int32_t _overloadRawHi;         // Raw-count overload thresholds,
+    int32_t _overloadRawLo;         // recomputed on cal/offset change
     bool _initialized;
+    bool _interruptMode;
+    bool _dmaReadout;
+
+    // Dual-channel scheduler state. Channel 2 keeps its own offset and
+    // calibration factor - the two inputs see different bridges.
+    bool _dualChannel;
+    uint8_t _activeChannel;         // Input the mux currently selects
+    uint8_t _chSettleLeft;          // Conversions to discard post-switch
+    uint8_t _chPrimaryDone;         // Primary samples since last switch
+    int32_t _offset2;
+    float _calibrationFactor2;
+    int32_t _lastRaw2;
+    mutable float _lastForce2;      // Converted lazily, like _lastForce
+    mutable bool _forceDirty2;
+    uint32_t _sampleCount2;
+
+    // HISPEED decimation filter state
+    bool _hispeedMode;
+    uint8_t _decimation;
+    int64_t _filterSum;
+    uint8_t _filterCount;
+
+    // Async tare/average accumulator, fed one emitted sample at a time
+    // from applySample() - replaces the while(!isReady()) sleep loops
+    enum class AsyncOp : uint8_t { NONE, TARE, AVERAGE };
+    AsyncOp _asyncOp;
+    uint8_t _asyncTarget;       // Samples requested
+    uint8_t _asyncCount;        // Samples accumulated so far
+    int64_t _asyncSum;
+    int32_t _asyncResultRaw;    // Last completed average (raw counts)
+
+    // Background AFE calibration state - begin() starts it, readForce()
+    // polls it to completion, then the startup tare runs asynchronously
+    bool _afeCalibrating;
+    bool _afeCalOk;
+    bool _startupTareDone;
+    uint32_t _afeCalStartMs;
+    uint32_t _afeLastPollMs;
+
+    /**
+     * @brief Fetch the conversion result that DRDY signalled
+     * @return Raw ADC value
+     */
+    int32_t fetchConversion();
+
+    /**
+     * @brief Route one raw conversion to the owning channel
+     *
+     * Single-channel mode passes straight through to applySample().
+     * In dual-channel mode this is the interleave scheduler: it drops
+     * post-switch settling conversions, books channel-2 results, and
+     * flips the mux at the interleave boundaries.
+     *
+     * @param raw Raw ADC value
+     */
+    void ingestSample(int32_t raw);
+
+    /**
+     * @brief Point the input mux at a channel (non-blocking)
+     *
+     * One short CTRL2 write in thread context; the conversion pipeline
+     * keeps running and the settling counter handles the rest.
+     *
+     * @param channel 0 for the primary input, 1 for channel 2
+     */
+    void switchChannel(uint8_t channel);
+
+    /**
+     * @brief Feed one raw conversion through the decimation filter
+     *
+     * Updates the cached raw/force values - directly in normal mode,
+     * or once per completed boxcar in HISPEED mode.
+     *
+     * @param raw Raw ADC value
+     */
+    void applySample(int32_t raw);
+
+    /**
+     * @brief Feed one emitted sample into the async accumulator
+     *
+     * Applies the tare offset or stores the average when the requested
+     * sample count is reached.
+     *
+     * @param raw Raw ADC value
+     */
+    void accumulateAsync(int32_t raw);
+
+    /**
+     * @brief Poll the in-flight AFE calibration (throttled)
+     *
+     * When calibration completes, starts conversions and kicks off the
+     * asynchronous startup tare.
+     */
+    void pollAfeCalibration();
+
+    /**
+     * @brief Recompute raw-count overload thresholds
+     *
+     * Called whenever the calibration factor or offset changes.
+     */
+    void updateRawThresholds();
+
+    /**
+     * @brief Wait out an in-flight DMA sample read before bus access
+     *
+     * A chained-DMA readout feeds the I2C controller's IC_DATA_CMD
+     * directly; a blocking register transaction started mid-read would
+     * interleave command words from two transactions and corrupt both.
+     * Bounded wait (~100us worst case on the wire); the landed sample
+     * stays in the DMA buffer for the next readForce() to collect.
+     */
+    void dmaQuiesce();
 
     /**
      * @brief Write to NAU7802 register
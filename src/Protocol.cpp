@@ -1,8 +1,13 @@
 #include "Protocol.h"
+#include "SerialTx.h"
+#include "Stats.h"
+#include "Scheduler.h"
 #include "pico/stdlib.h"
+#include "tusb.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <ctype.h>
 
 // Device identification
@@ -10,11 +15,57 @@ static const char* DEVICE_NAME = "TensileTester";
 static const char* DEVICE_VERSION = "2.0.0";
 static const char* DEVICE_MANUFACTURER = "DIY-Pico";
 
+/**
+ * @brief CRC-8 (polynomial 0x07) over a byte range
+ */
+static uint8_t crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Format a message and enqueue it on the non-blocking TX ring
+ *
+ * Replaces direct printf: formatting happens into a stack buffer and
+ * the bytes go to SerialTx, so no send method can block on the host.
+ */
+static void txFormat(bool droppable, const char* fmt, ...) {
+    char buffer[224];   // Sized for the widest STATS histogram line
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+
+    if (len <= 0) return;
+    if (len >= (int)sizeof(buffer)) len = sizeof(buffer) - 1;
+
+    serialTxWrite(buffer, (size_t)len, droppable);
+}
+
 Protocol::Protocol()
     : _bufferIndex(0)
+    , _rxHead(0)
+    , _rxTail(0)
+    , _rxCount(0)
     , _parameter(0.0f)
     , _hasParameter(false)
     , _dataStreaming(false)
+    , _encoding(DataEncoding::ASCII)
+    , _txSequence(0)
+    , _deltaCountdown(0)
+    , _deltaLastTime(0)
+    , _deltaLastForceMn(0)
+    , _deltaLastExtUm(0)
+    , _dataHead(0)
+    , _dataTail(0)
+    , _dataCount(0)
+    , _dataDropped(0)
 {
     memset(_buffer, 0, COMMAND_BUFFER_SIZE);
 }
@@ -26,8 +77,27 @@ void Protocol::begin(uint32_t baudRate) {
 }
 
 Command Protocol::processInput() {
-    int c;
-    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+    // Pull everything the CDC FIFO has into the RX ring - bulk reads
+    // straight off TinyUSB, same direct-access pattern as SerialTx on
+    // the write side (stdio only ever sees our output, never input)
+    while (_rxCount < RX_RING_SIZE && tud_cdc_available() > 0) {
+        uint32_t chunk = (uint32_t)(RX_RING_SIZE - _rxCount);
+        uint32_t toEnd = (uint32_t)(RX_RING_SIZE - _rxHead);
+        if (chunk > toEnd) chunk = toEnd;
+
+        uint32_t got = tud_cdc_read(&_rxRing[_rxHead], chunk);
+        if (got == 0) break;
+        _rxHead = (uint16_t)((_rxHead + got) % RX_RING_SIZE);
+        _rxCount = (uint16_t)(_rxCount + got);
+    }
+
+    // Scan the buffered bytes for the next complete line - pure memory
+    // traffic, so a queued burst parses out one command per call
+    while (_rxCount > 0) {
+        char c = _rxRing[_rxTail];
+        _rxTail = (uint16_t)((_rxTail + 1) % RX_RING_SIZE);
+        _rxCount--;
+
         // Handle line endings
         if (c == '\n' || c == '\r') {
             if (_bufferIndex > 0) {
@@ -49,7 +119,7 @@ Command Protocol::processInput() {
         }
         // Add character to buffer
         else if (_bufferIndex < COMMAND_BUFFER_SIZE - 1) {
-            _buffer[_bufferIndex++] = (char)c;
+            _buffer[_bufferIndex++] = c;
         }
     }
     
@@ -69,76 +139,258 @@ bool Protocol::hasParameter() const {
 }
 
 void Protocol::sendOK(const char* message) {
-    printf("OK");
     if (message && strlen(message) > 0) {
-        printf(" %s", message);
+        txFormat(false, "OK %s\n", message);
+    } else {
+        txFormat(false, "OK\n");
     }
-    printf("\n");
 }
 
-void Protocol::sendError(ResponseStatus status, const char* message) {
-    printf("ERROR %d ", (int)status);
-    
-    // Print error description
+/**
+ * @brief Map a response status to its description string
+ */
+static const char* errorDescription(ResponseStatus status) {
     switch (status) {
-        case ResponseStatus::ERROR_UNKNOWN_CMD:
-            printf("Unknown command");
-            break;
-        case ResponseStatus::ERROR_INVALID_PARAM:
-            printf("Invalid parameter");
-            break;
-        case ResponseStatus::ERROR_NOT_READY:
-            printf("Not ready");
-            break;
-        case ResponseStatus::ERROR_BUSY:
-            printf("Busy");
-            break;
-        case ResponseStatus::ERROR_OVERLOAD:
-            printf("Force overload");
-            break;
-        case ResponseStatus::ERROR_LIMIT_REACHED:
-            printf("Limit reached");
-            break;
-        case ResponseStatus::ERROR_NOT_HOMED:
-            printf("Not homed");
-            break;
-        case ResponseStatus::ERROR_EMERGENCY:
-            printf("Emergency stop");
-            break;
-        default:
-            printf("Unknown error");
-            break;
+        case ResponseStatus::ERROR_UNKNOWN_CMD:   return "Unknown command";
+        case ResponseStatus::ERROR_INVALID_PARAM: return "Invalid parameter";
+        case ResponseStatus::ERROR_NOT_READY:     return "Not ready";
+        case ResponseStatus::ERROR_BUSY:          return "Busy";
+        case ResponseStatus::ERROR_OVERLOAD:      return "Force overload";
+        case ResponseStatus::ERROR_LIMIT_REACHED: return "Limit reached";
+        case ResponseStatus::ERROR_NOT_HOMED:     return "Not homed";
+        case ResponseStatus::ERROR_EMERGENCY:     return "Emergency stop";
+        default:                                  return "Unknown error";
     }
-    
+}
+
+void Protocol::sendError(ResponseStatus status, const char* message) {
     if (message && strlen(message) > 0) {
-        printf(": %s", message);
+        txFormat(false, "ERROR %d %s: %s\n",
+                 (int)status, errorDescription(status), message);
+    } else {
+        txFormat(false, "ERROR %d %s\n", (int)status, errorDescription(status));
     }
-    printf("\n");
 }
 
 void Protocol::sendStatus(const char* state, float force, float position, bool isRunning) {
-    printf("STATUS %s F:%.2f P:%.3f R:%d\n", state, force, position, isRunning ? 1 : 0);
+    // Periodic GUI polling traffic - droppable under backpressure so it
+    // never starves DATA packets or command responses
+    txFormat(true, "STATUS %s F:%.2f P:%.3f R:%d\n",
+             state, force, position, isRunning ? 1 : 0);
 }
 
 void Protocol::sendForce(float force) {
-    printf("FORCE %.3f\n", force);
+    txFormat(false, "FORCE %.3f\n", force);
+}
+
+void Protocol::sendDualForce(float force, float secondary) {
+    txFormat(false, "FORCE %.3f CH2 %.3f\n", force, secondary);
 }
 
 void Protocol::sendPosition(float position) {
-    printf("POS %.3f\n", position);
+    txFormat(false, "POS %.3f\n", position);
 }
 
 void Protocol::sendConfig(float speed, float maxForce, float maxExtension, uint32_t sampleRate) {
-    printf("CONFIG SPD:%.2f MAXF:%.1f MAXE:%.1f SR:%lu\n", speed, maxForce, maxExtension, sampleRate);
+    txFormat(false, "CONFIG SPD:%.2f MAXF:%.1f MAXE:%.1f SR:%lu\n",
+             speed, maxForce, maxExtension, sampleRate);
+}
+
+void Protocol::sendStats() {
+    for (uint8_t i = 0; i < (uint8_t)StatChannel::CHANNEL_COUNT; i++) {
+        const ChannelStats& ch = statsGet((StatChannel)i);
+        uint32_t mean = ch.count > 0 ? (uint32_t)(ch.sumUs / ch.count) : 0;
+
+        // Histogram as slash-separated power-of-two buckets
+        char hist[STATS_HIST_BUCKETS * 11];
+        int pos = 0;
+        for (uint8_t b = 0; b < STATS_HIST_BUCKETS; b++) {
+            pos += snprintf(&hist[pos], sizeof(hist) - pos, "%s%lu",
+                            b > 0 ? "/" : "", (unsigned long)ch.hist[b]);
+        }
+
+        txFormat(false, "STATS %s N:%lu MAX:%luus AVG:%luus H:%s\n",
+                 statsChannelName((StatChannel)i),
+                 ch.count, ch.maxUs, mean, hist);
+    }
+
+    txFormat(false, "STATS TX Q:%u DROP:%lu\n",
+             serialTxQueued(), serialTxDropped());
+    txFormat(false, "STATS DATA Q:%u DROP:%lu\n",
+             queuedDataCount(), droppedDataCount());
+
+    // Scheduler deadline accounting - one line per registered task
+    for (uint8_t i = 0; i < schedulerTaskCount(); i++) {
+        const SchedTaskStats& task = schedulerTaskStats(i);
+        txFormat(false, "STATS TASK %s N:%lu OVR:%lu MAX:%luus LATE:%luus\n",
+                 task.name, task.runs, task.overruns,
+                 task.maxUs, task.maxLateUs);
+    }
+}
+
+void Protocol::sendAnalysis(float modulus, float energy, uint32_t samples) {
+    txFormat(false, "ANALYSIS MOD:%.2f EN:%.4f N:%lu\n", modulus, energy, samples);
+}
+
+void Protocol::sendSampleEvents(uint32_t timeSamples, uint32_t forceEvents,
+                                uint32_t slopeEvents, uint32_t peakEvents,
+                                uint32_t dropEvents) {
+    txFormat(false, "EVENTS T:%lu F:%lu S:%lu P:%lu D:%lu\n",
+             timeSamples, forceEvents, slopeEvents, peakEvents, dropEvents);
+}
+
+void Protocol::sendPretrigStart(uint32_t count) {
+    txFormat(false, "PRETRIG START %lu\n", (unsigned long)count);
+}
+
+void Protocol::sendPretrigRecord(uint32_t timestamp, int32_t rawForce,
+                                 int32_t position) {
+    txFormat(false, "PT %lu,%ld,%ld\n",
+             (unsigned long)timestamp, (long)rawForce, (long)position);
+}
+
+void Protocol::sendPretrigEnd() {
+    txFormat(false, "PRETRIG END\n");
+}
+
+// --- Delta encoding helpers ------------------------------------------------
+
+/**
+ * @brief Append an LEB128-style unsigned varint
+ * @return Bytes written (1-5)
+ */
+static size_t varintPut(uint8_t* out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * @brief Zigzag-map a signed delta so small magnitudes stay small
+ */
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+/**
+ * @brief Quantize a float to integer thousandths, round-to-nearest
+ */
+static inline int32_t toThousandths(float v) {
+    return (int32_t)(v * 1000.0f + (v >= 0.0f ? 0.5f : -0.5f));
 }
 
 void Protocol::sendData(const DataPacket& packet) {
-    printf("DATA %lu,%.3f,%.4f,%.3f,%.6f\n", 
-           packet.timestamp, packet.force, packet.extension, packet.stress, packet.strain);
+    if (_encoding == DataEncoding::ASCII) {
+        txFormat(false, "DATA %lu,%.3f,%.4f,%.3f,%.6f\n",
+                 packet.timestamp, packet.force, packet.extension,
+                 packet.stress, packet.strain);
+        return;
+    }
+
+    if (_encoding == DataEncoding::DELTA && _deltaCountdown > 0) {
+        sendDeltaFrame(packet);
+        return;
+    }
+
+    // Fixed-size frame: sync, sequence, packed payload, CRC-8.
+    // No float formatting - just a memcpy onto the TX ring. In delta
+    // mode this is the periodic keyframe that re-anchors the stream.
+    uint8_t frame[BINARY_FRAME_SIZE];
+    frame[0] = BINARY_FRAME_SYNC;
+    frame[1] = _txSequence++;
+    memcpy(&frame[2], &packet, sizeof(DataPacket));
+    frame[BINARY_FRAME_SIZE - 1] = crc8(&frame[1], 1 + sizeof(DataPacket));
+
+    serialTxWrite(frame, BINARY_FRAME_SIZE, false);
+
+    if (_encoding == DataEncoding::DELTA) {
+        _deltaCountdown = DELTA_KEYFRAME_INTERVAL - 1;
+        _deltaLastTime = packet.timestamp;
+        _deltaLastForceMn = toThousandths(packet.force);
+        _deltaLastExtUm = toThousandths(packet.extension);
+    }
+}
+
+void Protocol::sendDeltaFrame(const DataPacket& packet) {
+    int32_t forceMn = toThousandths(packet.force);
+    int32_t extUm = toThousandths(packet.extension);
+
+    uint8_t frame[DELTA_FRAME_MAX];
+    size_t n = 1;
+    frame[0] = DELTA_FRAME_SYNC;
+    n += varintPut(&frame[n], packet.timestamp - _deltaLastTime);
+    n += varintPut(&frame[n], zigzag(forceMn - _deltaLastForceMn));
+    n += varintPut(&frame[n], zigzag(extUm - _deltaLastExtUm));
+    frame[n] = crc8(&frame[1], n - 1);
+    n++;
+
+    serialTxWrite(frame, n, false);
+
+    _deltaLastTime = packet.timestamp;
+    _deltaLastForceMn = forceMn;
+    _deltaLastExtUm = extUm;
+    _deltaCountdown--;
+}
+
+void Protocol::queueData(const DataPacket& packet) {
+    if (_dataCount >= DATA_RING_SIZE) {
+        // Drop oldest: advancing the tail keeps the newest samples,
+        // which is what the host wants after a stall
+        _dataTail = (_dataTail + 1) % DATA_RING_SIZE;
+        _dataCount--;
+        _dataDropped++;
+    }
+
+    _dataRing[_dataHead] = packet;
+    _dataHead = (_dataHead + 1) % DATA_RING_SIZE;
+    _dataCount++;
+}
+
+void Protocol::drainData() {
+    uint8_t sent = 0;
+    while (_dataCount > 0 && sent < DATA_DRAIN_BATCH) {
+        sendData(_dataRing[_dataTail]);
+        _dataTail = (_dataTail + 1) % DATA_RING_SIZE;
+        _dataCount--;
+        sent++;
+    }
+
+    // Push whatever the host has made room for out of the TX ring
+    serialTxDrain();
+}
+
+uint16_t Protocol::queuedDataCount() const {
+    return _dataCount;
+}
+
+uint32_t Protocol::droppedDataCount() const {
+    return _dataDropped;
+}
+
+void Protocol::setBinaryMode(bool enable) {
+    setEncoding(enable ? DataEncoding::BINARY : DataEncoding::ASCII);
+}
+
+bool Protocol::isBinaryMode() const {
+    return _encoding == DataEncoding::BINARY;
+}
+
+void Protocol::setEncoding(DataEncoding encoding) {
+    _encoding = encoding;
+    _txSequence = 0;
+    _deltaCountdown = 0;    // Next delta sample re-anchors with a keyframe
+}
+
+DataEncoding Protocol::getEncoding() const {
+    return _encoding;
 }
 
 void Protocol::sendIdentity() {
-    printf("ID %s V%s %s\n", DEVICE_NAME, DEVICE_VERSION, DEVICE_MANUFACTURER);
+    txFormat(false, "ID %s V%s %s\n", DEVICE_NAME, DEVICE_VERSION, DEVICE_MANUFACTURER);
 }
 
 void Protocol::setDataStreaming(bool enable) {
@@ -150,59 +402,112 @@ bool Protocol::isDataStreaming() const {
 }
 
 void Protocol::clearBuffer() {
+    // Only the input buffer - the parsed parameter must survive this
+    // call, which processInput() makes between parsing a line and the
+    // caller acting on the returned command
     memset(_buffer, 0, COMMAND_BUFFER_SIZE);
     _bufferIndex = 0;
-    _hasParameter = false;
 }
 
+// Command dispatch table, sorted alphabetically so every first letter
+// occupies one contiguous bucket. Parsing probes only the bucket for
+// the command's first character instead of strcmp-ing the whole
+// vocabulary - the table and its bucket index are built at compile time.
+struct CommandEntry {
+    const char* name;
+    Command cmd;
+};
+
+static constexpr CommandEntry COMMAND_TABLE[] = {
+    {"ANALYSIS",  Command::GET_ANALYSIS},
+    {"AREA",      Command::SET_AREA},
+    {"BINMODE",   Command::SET_BINARY_MODE},
+    {"CAL",       Command::CALIBRATE},
+    {"CALFACTOR", Command::SET_CAL_FACTOR},
+    {"CONFIG",    Command::GET_CONFIG},
+    {"DATA",      Command::GET_DATA},
+    {"DOWN",      Command::MOVE_DOWN},
+    {"DUAL",      Command::SET_DUAL_CHANNEL},
+    {"DUMP",      Command::DUMP_CAPTURE},
+    {"ESTOP",     Command::EMERGENCY_STOP},
+    {"EVDELTA",   Command::SET_EVENT_DELTA},
+    {"EVDROP",    Command::SET_EVENT_DROP},
+    {"EVGAP",     Command::SET_EVENT_GAP},
+    {"EVSLOPE",   Command::SET_EVENT_SLOPE},
+    {"FORCE",     Command::GET_FORCE},
+    {"GAUGE",     Command::SET_GAUGE},
+    {"GOTO",      Command::MOVE_TO},
+    {"HALT",      Command::STOP_MOVEMENT},
+    {"HISPEED",   Command::SET_HISPEED},
+    {"HOLD",      Command::START_HOLD_FORCE},
+    {"HOME",      Command::HOME},
+    {"ID",        Command::IDENTIFY},
+    {"MAXEXT",    Command::SET_MAX_EXTENSION},
+    {"MAXFORCE",  Command::SET_MAX_FORCE},
+    {"PAUSE",     Command::PAUSE_TEST},
+    {"POS",       Command::GET_POSITION},
+    {"RESET",     Command::RESET},
+    {"RESUME",    Command::RESUME_TEST},
+    {"SAVE",      Command::SAVE_CONFIG},
+    {"SPEED",     Command::SET_SPEED},
+    {"SRATE",     Command::SET_SAMPLE_RATE},
+    {"START",     Command::START_TEST},
+    {"STATS",     Command::GET_STATS},
+    {"STATUS",    Command::GET_STATUS},
+    {"STOP",      Command::STOP_TEST},
+    {"STRAINRATE", Command::START_STRAIN_RATE},
+    {"TARE",      Command::TARE},
+    {"UP",        Command::MOVE_UP},
+};
+
+static constexpr size_t COMMAND_COUNT = sizeof(COMMAND_TABLE) / sizeof(COMMAND_TABLE[0]);
+
+// start[c - 'A'] is the first table slot whose name begins with c;
+// start[26] closes the last bucket. Computed at compile time, so a
+// misordered table entry shows up as a wrong (empty) bucket in review,
+// not as a runtime sort.
+struct CommandIndex {
+    uint8_t start[27];
+};
+
+static constexpr CommandIndex buildCommandIndex() {
+    CommandIndex idx{};
+    size_t slot = 0;
+    for (int c = 0; c < 26; c++) {
+        idx.start[c] = (uint8_t)slot;
+        while (slot < COMMAND_COUNT && COMMAND_TABLE[slot].name[0] == 'A' + c) {
+            slot++;
+        }
+    }
+    idx.start[26] = (uint8_t)COMMAND_COUNT;
+    return idx;
+}
+
+static constexpr CommandIndex COMMAND_INDEX = buildCommandIndex();
+
 Command Protocol::parseCommand(const char* cmd) {
     // Convert to uppercase for case-insensitive comparison
     char upper[32];
     size_t len = strlen(cmd);
     if (len >= sizeof(upper)) len = sizeof(upper) - 1;
-    
+
     for (size_t i = 0; i < len; i++) {
         upper[i] = toupper(cmd[i]);
     }
     upper[len] = '\0';
-    
-    // Test Control
-    if (strcmp(upper, "START") == 0) return Command::START_TEST;
-    if (strcmp(upper, "STOP") == 0) return Command::STOP_TEST;
-    if (strcmp(upper, "PAUSE") == 0) return Command::PAUSE_TEST;
-    if (strcmp(upper, "RESUME") == 0) return Command::RESUME_TEST;
-    if (strcmp(upper, "ESTOP") == 0) return Command::EMERGENCY_STOP;
-    
-    // Movement
-    if (strcmp(upper, "UP") == 0) return Command::MOVE_UP;
-    if (strcmp(upper, "DOWN") == 0) return Command::MOVE_DOWN;
-    if (strcmp(upper, "GOTO") == 0) return Command::MOVE_TO;
-    if (strcmp(upper, "HALT") == 0) return Command::STOP_MOVEMENT;
-    if (strcmp(upper, "HOME") == 0) return Command::HOME;
-    
-    // Configuration
-    if (strcmp(upper, "SPEED") == 0) return Command::SET_SPEED;
-    if (strcmp(upper, "MAXFORCE") == 0) return Command::SET_MAX_FORCE;
-    if (strcmp(upper, "MAXEXT") == 0) return Command::SET_MAX_EXTENSION;
-    if (strcmp(upper, "SRATE") == 0) return Command::SET_SAMPLE_RATE;
-    
-    // Calibration
-    if (strcmp(upper, "TARE") == 0) return Command::TARE;
-    if (strcmp(upper, "CAL") == 0) return Command::CALIBRATE;
-    if (strcmp(upper, "CALFACTOR") == 0) return Command::SET_CAL_FACTOR;
-    
-    // Query
-    if (strcmp(upper, "STATUS") == 0) return Command::GET_STATUS;
-    if (strcmp(upper, "FORCE") == 0) return Command::GET_FORCE;
-    if (strcmp(upper, "POS") == 0) return Command::GET_POSITION;
-    if (strcmp(upper, "CONFIG") == 0) return Command::GET_CONFIG;
-    if (strcmp(upper, "DATA") == 0) return Command::GET_DATA;
-    
-    // System
-    if (strcmp(upper, "RESET") == 0) return Command::RESET;
-    if (strcmp(upper, "ID") == 0) return Command::IDENTIFY;
-    if (strcmp(upper, "?") == 0) return Command::IDENTIFY;
-    
+
+    // "?" is the only non-alphabetic command
+    if (upper[0] == '?' && upper[1] == '\0') return Command::IDENTIFY;
+    if (upper[0] < 'A' || upper[0] > 'Z') return Command::UNKNOWN;
+
+    // Probe just the first-letter bucket - at most three entries today
+    uint8_t bucket = (uint8_t)(upper[0] - 'A');
+    for (uint8_t i = COMMAND_INDEX.start[bucket]; i < COMMAND_INDEX.start[bucket + 1]; i++) {
+        if (strcmp(upper, COMMAND_TABLE[i].name) == 0) {
+            return COMMAND_TABLE[i].cmd;
+        }
+    }
+
     return Command::UNKNOWN;
 }
 
@@ -12,6 +12,8 @@ enum class Command : uint8_t {
     
     // Test Control Commands
     START_TEST,         // Start tensile test
+    START_HOLD_FORCE,   // Start closed-loop force-hold test (creep)
+    START_STRAIN_RATE,  // Start constant-strain-rate test
     STOP_TEST,          // Stop current test
     PAUSE_TEST,         // Pause current test
     RESUME_TEST,        // Resume paused test
@@ -29,6 +31,14 @@ enum class Command : uint8_t {
     SET_MAX_FORCE,      // Set maximum force limit
     SET_MAX_EXTENSION,  // Set maximum extension limit
     SET_SAMPLE_RATE,    // Set data sample rate
+    SET_EVENT_DELTA,    // Adaptive sampling: force-change threshold (N)
+    SET_EVENT_SLOPE,    // Adaptive sampling: slope-change ratio
+    SET_EVENT_DROP,     // Adaptive sampling: drop-from-peak ratio
+    SET_EVENT_GAP,      // Adaptive sampling: min event spacing (ms)
+    SET_HISPEED,        // 320 SPS acquisition with decimation filter
+    SET_DUAL_CHANNEL,   // Interleave the NAU7802's second input channel
+    SET_AREA,           // Set specimen cross-sectional area (mm^2)
+    SET_GAUGE,          // Set specimen gauge length (mm)
     
     // Calibration Commands
     TARE,               // Tare the load cell
@@ -37,14 +47,19 @@ enum class Command : uint8_t {
     
     // Query Commands
     GET_STATUS,         // Get current status
+    GET_STATS,          // Get hot-path timing statistics
     GET_FORCE,          // Get current force reading
     GET_POSITION,       // Get current position
     GET_CONFIG,         // Get current configuration
     GET_DATA,           // Get test data point
+    GET_ANALYSIS,       // Get live modulus/energy analytics
+    DUMP_CAPTURE,       // Replay flash-captured test data
     
     // System Commands
     RESET,              // Reset system
     IDENTIFY,           // Get device identification
+    SET_BINARY_MODE,    // Switch DATA stream between ASCII and binary framing
+    SAVE_CONFIG,        // Persist calibration and test parameters to flash
     
     UNKNOWN = 0xFF
 };
@@ -75,6 +90,36 @@ struct DataPacket {
     float strain;           // Calculated strain (if applicable)
 };
 
+// Binary DATA frame layout (BINMODE):
+//   [0]      sync byte (BINARY_FRAME_SYNC)
+//   [1]      sequence number (wraps at 255, lets the host spot drops)
+//   [2..21]  DataPacket, packed little-endian (20 bytes)
+//   [22]     CRC-8 (poly 0x07) over bytes [1..21]
+#define BINARY_FRAME_SYNC   0xAA
+#define BINARY_FRAME_SIZE   (2 + (int)sizeof(DataPacket) + 1)
+
+// Delta DATA frame layout (BINMODE 2). Every DELTA_KEYFRAME_INTERVAL
+// samples a full binary keyframe (above) re-anchors the stream; the
+// samples in between are a few bytes each:
+//   [0]    sync byte (DELTA_FRAME_SYNC)
+//   [1..]  unsigned varint: ms since the previous sample
+//   [..]   zigzag varint:   force delta (milli-newtons)
+//   [..]   zigzag varint:   extension delta (micrometres)
+//   [last] CRC-8 (poly 0x07) over the varint bytes
+// Stress/strain are reconstructed host-side from force/extension and
+// the specimen geometry, so they are not carried per sample.
+#define DELTA_FRAME_SYNC    0xAB
+#define DELTA_FRAME_MAX     (1 + 5 + 5 + 5 + 1)
+
+/**
+ * @brief Wire encodings for the DATA stream
+ */
+enum class DataEncoding : uint8_t {
+    ASCII  = 0,     // "DATA t,f,e,..." text lines
+    BINARY = 1,     // Fixed-size framed packets
+    DELTA  = 2,     // Binary keyframes + varint delta frames
+};
+
 /**
  * @brief Serial protocol handler for PC communication
  * 
@@ -96,6 +141,13 @@ public:
 
     /**
      * @brief Process incoming serial data
+     *
+     * Pulls whole USB CDC buffers into an RX ring in one read - no
+     * per-byte stdio round-trips - then scans the buffered bytes for
+     * the next complete line. A burst of commands from a scripted host
+     * lands in the ring on the first call and parses out one command
+     * per call with no further USB traffic.
+     *
      * @return Parsed command (NONE if no complete command)
      */
     Command processInput();
@@ -146,6 +198,13 @@ public:
      */
     void sendForce(float force);
 
+    /**
+     * @brief Send force readings for both channels (dual-channel mode)
+     * @param force Primary channel force in Newtons
+     * @param secondary Channel-2 force in Newtons
+     */
+    void sendDualForce(float force, float secondary);
+
     /**
      * @brief Send position reading
      * @param position Position in mm
@@ -161,12 +220,132 @@ public:
      */
     void sendConfig(float speed, float maxForce, float maxExtension, uint32_t sampleRate);
 
+    /**
+     * @brief Send the hot-path timing statistics (STATS command)
+     *
+     * One line per instrumented channel - count, high-water mark, mean
+     * and the power-of-two histogram - plus the TX ring and data ring
+     * occupancy/drop counters, so field stutters can be attributed to
+     * USB backpressure, I2C waits or step timing without a debug probe.
+     */
+    void sendStats();
+
+    /**
+     * @brief Send live analytics readout
+     * @param modulus Elastic modulus estimate (MPa)
+     * @param energy Energy under the curve (J)
+     * @param samples Samples in the modulus fit
+     */
+    void sendAnalysis(float modulus, float energy, uint32_t samples);
+
+    /**
+     * @brief Send the per-test adaptive-sampling event breakdown
+     *
+     * Emitted at test end so a host tuning the EV* thresholds can see
+     * which event types actually drove the extra samples.
+     *
+     * @param timeSamples Samples taken on the periodic tick
+     * @param forceEvents Force-change events fired
+     * @param slopeEvents Slope-change events fired
+     * @param peakEvents New-peak events fired
+     * @param dropEvents Drop-from-peak events fired
+     */
+    void sendSampleEvents(uint32_t timeSamples, uint32_t forceEvents,
+                          uint32_t slopeEvents, uint32_t peakEvents,
+                          uint32_t dropEvents);
+
+    /**
+     * @brief Send the pre-trigger replay start marker
+     * @param count Records that will follow
+     */
+    void sendPretrigStart(uint32_t count);
+
+    /**
+     * @brief Send one pre-trigger record ("PT timestamp,raw,position")
+     * @param timestamp Sample time (ms since boot)
+     * @param rawForce Raw ADC counts
+     * @param position Crosshead position in steps
+     */
+    void sendPretrigRecord(uint32_t timestamp, int32_t rawForce, int32_t position);
+
+    /**
+     * @brief Send the pre-trigger replay end marker
+     */
+    void sendPretrigEnd();
+
     /**
      * @brief Send test data point
+     *
+     * Emits either the ASCII "DATA ..." line or, in binary mode, a
+     * fixed-size framed packet (sync, sequence, payload, CRC). Binary
+     * framing skips float formatting entirely - an order of magnitude
+     * less CPU and wire bytes per sample on the FPU-less Cortex-M0+.
+     *
      * @param packet Data packet to send
      */
     void sendData(const DataPacket& packet);
 
+    /**
+     * @brief Queue a data point into the sample ring buffer - O(1)
+     *
+     * Never blocks and never touches USB: the packet is copied into an
+     * on-device ring that drainData() empties in batches. When the ring
+     * is full the oldest packet is dropped, so a stalled host costs
+     * history, never control-loop time.
+     *
+     * @param packet Data packet to queue
+     */
+    void queueData(const DataPacket& packet);
+
+    /**
+     * @brief Drain queued data points and the TX ring to USB
+     *
+     * Call from the main loop. Formats at most DATA_DRAIN_BATCH packets
+     * per call onto the non-blocking TX ring, then moves ring bytes to
+     * the USB FIFO as the host makes space - never blocks on the host.
+     */
+    void drainData();
+
+    /**
+     * @brief Get number of packets waiting in the ring
+     * @return Queued packet count
+     */
+    uint16_t queuedDataCount() const;
+
+    /**
+     * @brief Get number of packets dropped due to backpressure
+     * @return Dropped packet count since begin()
+     */
+    uint32_t droppedDataCount() const;
+
+    /**
+     * @brief Switch the DATA stream between ASCII and binary framing
+     * @param enable true for binary frames
+     */
+    void setBinaryMode(bool enable);
+
+    /**
+     * @brief Check if binary DATA framing is enabled
+     * @return true if binary mode
+     */
+    bool isBinaryMode() const;
+
+    /**
+     * @brief Select the DATA stream encoding
+     *
+     * Switching resets the sequence counter and forces the next delta
+     * sample to start with a keyframe.
+     *
+     * @param encoding Wire encoding for sendData()
+     */
+    void setEncoding(DataEncoding encoding);
+
+    /**
+     * @brief Get the active DATA stream encoding
+     * @return Current encoding
+     */
+    DataEncoding getEncoding() const;
+
     /**
      * @brief Send device identification
      */
@@ -192,9 +371,38 @@ public:
 private:
     char _buffer[COMMAND_BUFFER_SIZE];
     uint8_t _bufferIndex;
+
+    // Bulk RX ring - raw USB bytes land here in whole-buffer reads,
+    // the line scanner consumes them without touching the bus again
+    char _rxRing[RX_RING_SIZE];
+    uint16_t _rxHead;       // Next write index
+    uint16_t _rxTail;       // Next read index
+    uint16_t _rxCount;      // Bytes buffered
     float _parameter;
     bool _hasParameter;
     bool _dataStreaming;
+    DataEncoding _encoding;
+    uint8_t _txSequence;
+
+    // Delta encoder state - last emitted sample in quantized integer
+    // units, plus the countdown to the next re-anchoring keyframe
+    uint8_t _deltaCountdown;
+    uint32_t _deltaLastTime;
+    int32_t _deltaLastForceMn;      // milli-newtons
+    int32_t _deltaLastExtUm;        // micrometres
+
+    // Sample ring buffer - decouples recordDataPoint() from USB latency
+    DataPacket _dataRing[DATA_RING_SIZE];
+    uint16_t _dataHead;     // Next write slot
+    uint16_t _dataTail;     // Next read slot
+    uint16_t _dataCount;    // Packets currently queued
+    uint32_t _dataDropped;  // Oldest-dropped count under backpressure
+
+    /**
+     * @brief Emit one delta frame and advance the encoder state
+     * @param packet Data packet to encode against the previous sample
+     */
+    void sendDeltaFrame(const DataPacket& packet);
 
     /**
      * @brief Parse command string to Command enum
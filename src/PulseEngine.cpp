@@ -0,0 +1,218 @@
+#include "PulseEngine.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/util/queue.h"
+#include "pico/flash.h"
+
+// Inter-core command queue. pico/util/queue is lock-free for the
+// single-producer (core 0) / single-consumer (core 1) case used here.
+#define PULSE_QUEUE_DEPTH   16
+
+static queue_t s_commandQueue;
+static bool s_queueReady = false;
+
+// Core 1 has no argument channel in multicore_launch_core1(), so the
+// engine instance is published through a file-scope pointer before launch.
+static PulseEngine* s_engine = nullptr;
+
+// Homing status flags, written by core 1 and polled by core 0.
+// Single-byte flags are atomic on the RP2040.
+static volatile bool s_homingActive = false;
+static volatile bool s_homingResult = false;
+
+PulseEngine::PulseEngine(Stepper& stepper)
+    : _stepper(stepper)
+    , _running(false)
+{
+}
+
+void PulseEngine::begin() {
+    if (_running) return;
+
+    if (!s_queueReady) {
+        queue_init(&s_commandQueue, sizeof(PulseCommand), PULSE_QUEUE_DEPTH);
+        s_queueReady = true;
+    }
+
+    s_engine = this;
+    multicore_launch_core1(core1Entry);
+
+    _running = true;
+}
+
+bool PulseEngine::isRunning() const {
+    return _running;
+}
+
+void PulseEngine::enable() {
+    postCommand({PulseCommandType::ENABLE, 0, 0.0f});
+}
+
+void PulseEngine::disable() {
+    postCommand({PulseCommandType::DISABLE, 0, 0.0f});
+}
+
+void PulseEngine::moveTo(int32_t position) {
+    postCommand({PulseCommandType::MOVE_TO, position, 0.0f});
+}
+
+void PulseEngine::moveToMm(float positionMm) {
+    moveTo(_stepper.mmToSteps(positionMm));
+}
+
+void PulseEngine::move(int32_t steps) {
+    postCommand({PulseCommandType::MOVE_RELATIVE, steps, 0.0f});
+}
+
+void PulseEngine::moveMm(float distanceMm) {
+    move(_stepper.mmToSteps(distanceMm));
+}
+
+void PulseEngine::setMaxSpeed(float speed) {
+    postCommand({PulseCommandType::SET_MAX_SPEED, 0, speed});
+}
+
+void PulseEngine::setSpeedMmPerSec(float mmPerSec) {
+    postCommand({PulseCommandType::SET_SPEED_MM, 0, mmPerSec});
+}
+
+void PulseEngine::setAcceleration(float acceleration) {
+    postCommand({PulseCommandType::SET_ACCELERATION, 0, acceleration});
+}
+
+void PulseEngine::setJerk(float jerk) {
+    postCommand({PulseCommandType::SET_JERK, 0, jerk});
+}
+
+void PulseEngine::setServoSpeedMmPerSec(float mmPerSec) {
+    postCommand({PulseCommandType::SET_SERVO_SPEED_MM, 0, mmPerSec});
+}
+
+void PulseEngine::stop() {
+    postCommand({PulseCommandType::STOP, 0, 0.0f});
+}
+
+void PulseEngine::stopSmooth() {
+    postCommand({PulseCommandType::STOP_SMOOTH, 0, 0.0f});
+}
+
+void PulseEngine::setCurrentPosition(int32_t position) {
+    postCommand({PulseCommandType::SET_POSITION, position, 0.0f});
+}
+
+void PulseEngine::startHoming(Direction dir) {
+    s_homingActive = true;
+    s_homingResult = false;
+    postCommand({PulseCommandType::HOME, (int32_t)dir, 0.0f});
+}
+
+bool PulseEngine::isHomingActive() const {
+    return s_homingActive;
+}
+
+bool PulseEngine::homingSucceeded() const {
+    return s_homingResult;
+}
+
+void PulseEngine::postCommand(const PulseCommand& cmd) {
+    if (!s_queueReady) {
+        // Engine not launched yet - queue commands for pickup at launch
+        queue_init(&s_commandQueue, sizeof(PulseCommand), PULSE_QUEUE_DEPTH);
+        s_queueReady = true;
+    }
+    // Blocking add: the queue only backs up if core 1 has died, and
+    // dropping motion commands silently would be worse than stalling.
+    queue_add_blocking(&s_commandQueue, &cmd);
+}
+
+void PulseEngine::core1Entry() {
+    s_engine->engineLoop();
+}
+
+void PulseEngine::engineLoop() {
+    PulseCommand cmd;
+
+    // Register as a flash-safe-execute victim so core 0 can program
+    // the capture region while this core parks briefly
+    flash_safe_execute_core_init();
+
+    // Claim a hardware alarm for this core: the default pool services
+    // its callbacks on core 0's timer IRQ, which would expose stepping
+    // to core 0's IRQs-off windows and race the ramp rebuilds below.
+    // Creating the pool here puts the step callbacks, the command
+    // handling and the table rebuilds all on core 1.
+    _stepper.setAlarmPool(alarm_pool_create_with_unused_hardware_alarm(4));
+
+    while (true) {
+        // Drain all pending commands before stepping
+        while (queue_try_remove(&s_commandQueue, &cmd)) {
+            switch (cmd.type) {
+                case PulseCommandType::ENABLE:
+                    _stepper.enable();
+                    break;
+                case PulseCommandType::DISABLE:
+                    _stepper.disable();
+                    break;
+                case PulseCommandType::MOVE_TO:
+                    _stepper.moveTo(cmd.intParam);
+                    break;
+                case PulseCommandType::MOVE_RELATIVE:
+                    _stepper.move(cmd.intParam);
+                    break;
+                case PulseCommandType::SET_MAX_SPEED:
+                    _stepper.setMaxSpeed(cmd.floatParam);
+                    break;
+                case PulseCommandType::SET_SPEED_MM:
+                    _stepper.setSpeedMmPerSec(cmd.floatParam);
+                    break;
+                case PulseCommandType::SET_ACCELERATION:
+                    _stepper.setAcceleration(cmd.floatParam);
+                    break;
+                case PulseCommandType::SET_JERK:
+                    _stepper.setJerk(cmd.floatParam);
+                    break;
+                case PulseCommandType::SET_SERVO_SPEED_MM:
+                    _stepper.setServoSpeedMmPerSec(cmd.floatParam);
+                    break;
+                case PulseCommandType::STOP:
+                    _stepper.stop();
+                    break;
+                case PulseCommandType::STOP_SMOOTH:
+                    _stepper.stopSmooth();
+                    break;
+                case PulseCommandType::SET_POSITION:
+                    _stepper.setCurrentPosition(cmd.intParam);
+                    break;
+                case PulseCommandType::HOME:
+                    // Non-blocking: startHome() kicks off the phase
+                    // machine, updateHome() below advances it - the
+                    // command queue keeps draining, so STOP or ESTOP
+                    // can abort a homing run mid-phase.
+                    if (!_stepper.startHome((Direction)cmd.intParam)) {
+                        s_homingResult = false;
+                        s_homingActive = false;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Advance the homing phase machine and publish its result
+        if (s_homingActive && _stepper.isHoming()) {
+            if (!_stepper.updateHome()) {
+                s_homingResult = _stepper.homeSucceeded();
+                s_homingActive = false;
+            }
+        }
+
+        // Run the motion loop at full speed - this is the only work on
+        // this core, so step timing jitter is bounded by the queue
+        // drain above, not by protocol or I2C activity on core 0.
+        if (_stepper.isEnabled()) {
+            _stepper.run();
+        }
+
+        tight_loop_contents();
+    }
+}
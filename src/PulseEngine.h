@@ -0,0 +1,198 @@
+#ifndef PULSEENGINE_H
+#define PULSEENGINE_H
+
+#include <stdint.h>
+#include "Config.h"
+#include "Stepper.h"
+
+/**
+ * @brief Commands accepted by the core-1 pulse engine
+ */
+enum class PulseCommandType : uint8_t {
+    NONE = 0,
+    ENABLE,             // Enable stepper driver
+    DISABLE,            // Disable stepper driver
+    MOVE_TO,            // Move to absolute position (steps)
+    MOVE_RELATIVE,      // Move relative distance (steps)
+    SET_MAX_SPEED,      // Set maximum speed (steps/sec)
+    SET_SPEED_MM,       // Set maximum speed (mm/s)
+    SET_ACCELERATION,   // Set acceleration (steps/sec^2)
+    SET_JERK,           // Set jerk limit (steps/sec^3)
+    SET_SERVO_SPEED_MM, // Velocity-servo command (mm/s, signed)
+    STOP,               // Stop immediately
+    STOP_SMOOTH,        // Stop with deceleration
+    SET_POSITION,       // Set current position without moving
+    HOME                // Run homing sequence
+};
+
+/**
+ * @brief Command record passed from core 0 to core 1
+ */
+struct PulseCommand {
+    PulseCommandType type;
+    int32_t intParam;       // Position / steps
+    float floatParam;       // Speed / acceleration
+};
+
+/**
+ * @brief Dedicated stepper pulse engine running on RP2040 core 1
+ *
+ * Owns the Stepper motion loop so that step timing never depends on how
+ * fast loop() on core 0 comes around. Core 0 (StateMachine/Protocol)
+ * posts motion commands through a lock-free inter-core queue; core 1
+ * drains the queue and calls Stepper::run() continuously, giving
+ * jitter-free stepping up to STEPPER_MAX_SPEED regardless of printf or
+ * I2C activity on core 0.
+ *
+ * Position and state queries go straight to the Stepper object - its
+ * position counters are single 32-bit words, which the RP2040 reads and
+ * writes atomically, so cross-core reads are safe without locking.
+ */
+class PulseEngine {
+public:
+    /**
+     * @brief Construct a new PulseEngine object
+     * @param stepper Stepper instance to drive from core 1
+     */
+    PulseEngine(Stepper& stepper);
+
+    /**
+     * @brief Launch the pulse engine on core 1
+     *
+     * Must be called once from core 0 after Stepper::begin().
+     */
+    void begin();
+
+    /**
+     * @brief Check if the engine is running on core 1
+     * @return true if running
+     */
+    bool isRunning() const;
+
+    // --- Motion commands (posted to core 1, non-blocking) ---
+
+    /**
+     * @brief Enable the stepper driver
+     */
+    void enable();
+
+    /**
+     * @brief Disable the stepper driver
+     */
+    void disable();
+
+    /**
+     * @brief Move to absolute position (steps)
+     * @param position Target position in steps
+     */
+    void moveTo(int32_t position);
+
+    /**
+     * @brief Move to absolute position (mm)
+     * @param positionMm Target position in millimeters
+     */
+    void moveToMm(float positionMm);
+
+    /**
+     * @brief Move relative distance (steps)
+     * @param steps Number of steps to move
+     */
+    void move(int32_t steps);
+
+    /**
+     * @brief Move relative distance (mm)
+     * @param distanceMm Distance in millimeters
+     */
+    void moveMm(float distanceMm);
+
+    /**
+     * @brief Set maximum speed
+     * @param speed Speed in steps per second
+     */
+    void setMaxSpeed(float speed);
+
+    /**
+     * @brief Set speed in mm/s
+     * @param mmPerSec Speed in millimeters per second
+     */
+    void setSpeedMmPerSec(float mmPerSec);
+
+    /**
+     * @brief Set acceleration
+     * @param acceleration Acceleration in steps per second squared
+     */
+    void setAcceleration(float acceleration);
+
+    /**
+     * @brief Set jerk limit for the S-curve ramp
+     * @param jerk Jerk in steps per second cubed
+     */
+    void setJerk(float jerk);
+
+    /**
+     * @brief Command a servo-mode velocity (closed-loop control)
+     *
+     * Cheap enough to post at the full sample rate - on core 1 it is a
+     * couple of stores, no ramp-table rebuild. Zero (or near-zero)
+     * speed disengages the servo and halts.
+     *
+     * @param mmPerSec Signed crosshead speed (positive = up)
+     */
+    void setServoSpeedMmPerSec(float mmPerSec);
+
+    /**
+     * @brief Stop motor immediately
+     */
+    void stop();
+
+    /**
+     * @brief Stop motor with deceleration
+     */
+    void stopSmooth();
+
+    /**
+     * @brief Set current position (without moving)
+     * @param position New current position
+     */
+    void setCurrentPosition(int32_t position);
+
+    /**
+     * @brief Start homing sequence on core 1
+     * @param dir Direction to home
+     */
+    void startHoming(Direction dir = Direction::DOWN);
+
+    /**
+     * @brief Check if a homing sequence is in progress
+     * @return true if homing
+     */
+    bool isHomingActive() const;
+
+    /**
+     * @brief Get result of the last homing sequence
+     * @return true if homing succeeded
+     */
+    bool homingSucceeded() const;
+
+private:
+    Stepper& _stepper;
+    bool _running;
+
+    /**
+     * @brief Post a command to the core-1 queue
+     * @param cmd Command to post
+     */
+    void postCommand(const PulseCommand& cmd);
+
+    /**
+     * @brief Core 1 entry point (static trampoline)
+     */
+    static void core1Entry();
+
+    /**
+     * @brief Core 1 main loop - drain commands, run stepper
+     */
+    void engineLoop();
+};
+
+#endif // PULSEENGINE_H
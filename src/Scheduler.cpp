@@ -0,0 +1,89 @@
+#include "Scheduler.h"
+#include "pico/stdlib.h"
+#include "hardware/watchdog.h"
+
+/**
+ * @brief One task table slot
+ */
+struct SchedTask {
+    SchedTaskFn fn;
+    uint32_t periodUs;
+    uint32_t budgetUs;
+    uint32_t dueUs;         // Next deadline (time_us_32() domain)
+    SchedTaskStats stats;
+};
+
+static SchedTask s_tasks[SCHED_MAX_TASKS];
+static uint8_t s_taskCount = 0;
+static bool s_watchdogOn = false;
+
+bool schedulerAddTask(const char* name, SchedTaskFn fn,
+                      uint32_t periodUs, uint32_t budgetUs) {
+    if (s_taskCount >= SCHED_MAX_TASKS || fn == nullptr) {
+        return false;
+    }
+
+    SchedTask& task = s_tasks[s_taskCount++];
+    task.fn = fn;
+    task.periodUs = periodUs;
+    task.budgetUs = budgetUs;
+    task.dueUs = 0;
+    task.stats = {name, 0, 0, 0, 0};
+    return true;
+}
+
+void schedulerBegin(void) {
+    uint32_t now = time_us_32();
+    for (uint8_t i = 0; i < s_taskCount; i++) {
+        s_tasks[i].dueUs = now + s_tasks[i].periodUs;
+    }
+
+    watchdog_enable(WATCHDOG_TIMEOUT_MS, true);
+    s_watchdogOn = true;
+}
+
+void schedulerRun(void) {
+    if (s_watchdogOn) {
+        watchdog_update();
+    }
+
+    for (uint8_t i = 0; i < s_taskCount; i++) {
+        SchedTask& task = s_tasks[i];
+
+        uint32_t now = time_us_32();
+        int32_t lateUs = (int32_t)(now - task.dueUs);
+        if (task.periodUs > 0 && lateUs < 0) {
+            continue;   // Not due yet
+        }
+
+        if ((uint32_t)lateUs > task.stats.maxLateUs && task.periodUs > 0) {
+            task.stats.maxLateUs = (uint32_t)lateUs;
+        }
+
+        task.fn();
+
+        uint32_t tookUs = time_us_32() - now;
+        task.stats.runs++;
+        if (tookUs > task.stats.maxUs) {
+            task.stats.maxUs = tookUs;
+        }
+        if (tookUs > task.budgetUs) {
+            task.stats.overruns++;
+        }
+
+        // Advance by one whole period; re-anchor after a stall so one
+        // long pass does not trigger a burst of catch-up runs
+        task.dueUs += task.periodUs;
+        if ((int32_t)(time_us_32() - task.dueUs) >= (int32_t)task.periodUs) {
+            task.dueUs = time_us_32() + task.periodUs;
+        }
+    }
+}
+
+uint8_t schedulerTaskCount(void) {
+    return s_taskCount;
+}
+
+const SchedTaskStats& schedulerTaskStats(uint8_t index) {
+    return s_tasks[index].stats;
+}
@@ -0,0 +1,87 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "Config.h"
+
+/**
+ * @brief Cooperative main-loop scheduler with deadline accounting
+ *
+ * Free-function module (like SerialTx/Stats) that replaces the
+ * "fastest loop wins" free-for-all on core 0. Each chunk of main-loop
+ * work registers as a task with a period and a time budget;
+ * schedulerRun() executes the due tasks once per pass and keeps books:
+ * runs, budget overruns, worst execution time and worst start lateness
+ * per task. Overruns are counted, never punished - a flash erase is
+ * allowed to blow its budget, but the STATS TASK lines make it visible.
+ *
+ * schedulerBegin() also finally enables the hardware watchdog and
+ * schedulerRun() feeds it. Every formerly blocking call on this core
+ * (tare, homing, flash capture) is asynchronous now, so the loop is
+ * guaranteed to come around well inside WATCHDOG_TIMEOUT_MS - unless
+ * something genuinely hangs (a wedged I2C bus, a runaway loop), in
+ * which case the watchdog resets the RP2040 and de-energizes the
+ * motor instead of freezing with it powered.
+ *
+ * Single-core, single-writer: tasks run strictly sequentially on
+ * core 0, so no locking anywhere.
+ */
+
+/**
+ * @brief Task entry point - runs to completion, must not block
+ */
+typedef void (*SchedTaskFn)(void);
+
+/**
+ * @brief Accumulated figures for one task
+ */
+struct SchedTaskStats {
+    const char* name;       // Short upper-case name for STATS output
+    uint32_t runs;          // Completed executions
+    uint32_t overruns;      // Executions that exceeded the budget
+    uint32_t maxUs;         // Worst execution time (us)
+    uint32_t maxLateUs;     // Worst start lateness past the deadline (us)
+};
+
+/**
+ * @brief Register a task - call during setup(), before schedulerBegin()
+ *
+ * @param name Short upper-case name for STATS output
+ * @param fn Task entry point
+ * @param periodUs Desired period between runs (0 = every pass)
+ * @param budgetUs Time budget per run; longer runs count as overruns
+ * @return true if registered, false if the table is full
+ */
+bool schedulerAddTask(const char* name, SchedTaskFn fn,
+                      uint32_t periodUs, uint32_t budgetUs);
+
+/**
+ * @brief Arm the task deadlines and enable the hardware watchdog
+ */
+void schedulerBegin(void);
+
+/**
+ * @brief Run one scheduler pass - call from the main loop
+ *
+ * Feeds the watchdog, then runs every task whose deadline has arrived,
+ * timing each against its budget. Deadlines advance by whole periods so
+ * a late pass does not shift the schedule; after a stall longer than a
+ * period the deadline re-anchors to now instead of replaying a burst
+ * of catch-up runs.
+ */
+void schedulerRun(void);
+
+/**
+ * @brief Get the number of registered tasks
+ * @return Task count
+ */
+uint8_t schedulerTaskCount(void);
+
+/**
+ * @brief Get the accumulated figures for a task
+ * @param index Task index, 0 .. schedulerTaskCount()-1
+ * @return Accumulated counters
+ */
+const SchedTaskStats& schedulerTaskStats(uint8_t index);
+
+#endif // SCHEDULER_H
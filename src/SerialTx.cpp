@@ -0,0 +1,80 @@
+#include "SerialTx.h"
+#include "Config.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#include <string.h>
+
+static uint8_t s_ring[TX_RING_SIZE];
+static uint16_t s_head = 0;     // Next write index
+static uint16_t s_tail = 0;     // Next read index
+static uint16_t s_count = 0;    // Bytes queued
+static uint32_t s_dropped = 0;  // Messages refused under backpressure
+
+bool serialTxWrite(const void* data, size_t len, bool droppable) {
+    size_t freeSpace = TX_RING_SIZE - s_count;
+
+    // Low-priority traffic may not eat into the reserve kept for test
+    // DATA and command responses
+    if (droppable && freeSpace < len + TX_RING_RESERVE) {
+        s_dropped++;
+        return false;
+    }
+    if (len > freeSpace) {
+        s_dropped++;
+        return false;
+    }
+
+    // All-or-nothing copy, wrapping at the ring boundary
+    const uint8_t* src = (const uint8_t*)data;
+    size_t firstChunk = TX_RING_SIZE - s_head;
+    if (firstChunk > len) firstChunk = len;
+    memcpy(&s_ring[s_head], src, firstChunk);
+    if (firstChunk < len) {
+        memcpy(&s_ring[0], src + firstChunk, len - firstChunk);
+    }
+    s_head = (uint16_t)((s_head + len) % TX_RING_SIZE);
+    s_count = (uint16_t)(s_count + len);
+
+    return true;
+}
+
+void serialTxDrain() {
+    if (s_count == 0) {
+        return;
+    }
+
+    // No host listening: discard so the ring never wedges full and
+    // later output is fresh when a host reconnects
+    if (!stdio_usb_connected()) {
+        s_tail = s_head;
+        s_count = 0;
+        return;
+    }
+
+    // Bounded by the FIFO space the host has freed - never blocks
+    uint32_t space = tud_cdc_write_available();
+    while (space > 0 && s_count > 0) {
+        uint32_t chunk = s_count;
+        uint32_t toEnd = TX_RING_SIZE - s_tail;
+        if (chunk > toEnd) chunk = toEnd;
+        if (chunk > space) chunk = space;
+
+        uint32_t written = tud_cdc_write(&s_ring[s_tail], chunk);
+        s_tail = (uint16_t)((s_tail + written) % TX_RING_SIZE);
+        s_count = (uint16_t)(s_count - written);
+
+        if (written < chunk) {
+            break;
+        }
+        space = tud_cdc_write_available();
+    }
+    tud_cdc_write_flush();
+}
+
+size_t serialTxQueued() {
+    return s_count;
+}
+
+uint32_t serialTxDropped() {
+    return s_dropped;
+}
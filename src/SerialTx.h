@@ -0,0 +1,51 @@
+#ifndef SERIALTX_H
+#define SERIALTX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Non-blocking USB CDC transmit layer
+ *
+ * Protocol's send methods enqueue whole messages into a TX ring and
+ * return immediately; serialTxDrain() moves bytes into the USB FIFO
+ * only as the host makes space. A wedged or slow host therefore costs
+ * output history, never control-loop time.
+ *
+ * Messages are enqueued atomically - all bytes or none - so a dropped
+ * message can never interleave garbage into the stream. Droppable
+ * (low-priority) traffic is refused while a reserve of ring space
+ * remains, keeping room for test DATA and command responses.
+ */
+
+/**
+ * @brief Enqueue one message into the TX ring
+ * @param data Message bytes
+ * @param len Message length
+ * @param droppable true for low-priority traffic (periodic STATUS)
+ * @return true if enqueued, false if dropped
+ */
+bool serialTxWrite(const void* data, size_t len, bool droppable = false);
+
+/**
+ * @brief Move ring contents to the USB FIFO - call from the main loop
+ *
+ * Never blocks: writes are bounded by the FIFO space the host has
+ * freed. If the host has disconnected the ring is discarded so it
+ * cannot wedge full.
+ */
+void serialTxDrain();
+
+/**
+ * @brief Get bytes currently queued in the ring
+ * @return Queued byte count
+ */
+size_t serialTxQueued();
+
+/**
+ * @brief Get messages dropped due to backpressure
+ * @return Dropped message count since boot
+ */
+uint32_t serialTxDropped();
+
+#endif // SERIALTX_H
@@ -0,0 +1,96 @@
+#include "Settings.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <string.h>
+#include <stddef.h>
+
+#define SETTINGS_MAGIC      0x53474643      // "CFGS"
+#define SETTINGS_VERSION    1
+
+// Parameter block for the flash_safe_execute callback
+struct SettingsFlashOp {
+    uint32_t offset;
+    const uint8_t* data;    // nullptr = erase
+    size_t size;
+};
+
+static void settingsFlashOpUnsafe(void* param) {
+    SettingsFlashOp* op = (SettingsFlashOp*)param;
+    if (op->data == nullptr) {
+        flash_range_erase(op->offset, op->size);
+    } else {
+        flash_range_program(op->offset, op->data, op->size);
+    }
+}
+
+static bool settingsFlashOp(uint32_t offset, const uint8_t* data, size_t size) {
+    SettingsFlashOp op = {offset, data, size};
+    return flash_safe_execute(settingsFlashOpUnsafe, &op, 100) == PICO_OK;
+}
+
+// CRC-32 (reflected, poly 0xEDB88320) over the block up to the crc field
+static uint32_t blockCrc(const SettingsBlock& block) {
+    const uint8_t* p = (const uint8_t*)&block;
+    size_t n = offsetof(SettingsBlock, crc);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+Settings::Settings()
+    : _loaded(false)
+{
+    memset(&_block, 0, sizeof(_block));
+}
+
+bool Settings::load() {
+    // Straight copy out of memory-mapped flash - no bus traffic
+    memcpy(&_block, (const void*)(XIP_BASE + SETTINGS_FLASH_OFFSET),
+           sizeof(_block));
+
+    _loaded = _block.magic == SETTINGS_MAGIC &&
+              _block.version == SETTINGS_VERSION &&
+              _block.length == sizeof(SettingsBlock) &&
+              _block.crc == blockCrc(_block);
+    return _loaded;
+}
+
+bool Settings::save(const SettingsBlock& block) {
+    _block = block;
+    _block.magic = SETTINGS_MAGIC;
+    _block.version = SETTINGS_VERSION;
+    _block.length = sizeof(SettingsBlock);
+    _block.crc = blockCrc(_block);
+
+    if (!settingsFlashOp(SETTINGS_FLASH_OFFSET, nullptr, FLASH_SECTOR_SIZE)) {
+        return false;
+    }
+
+    // Program a whole page with the block at the front, 0xFF tail
+    uint8_t page[FLASH_PAGE_SIZE];
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, &_block, sizeof(_block));
+    if (!settingsFlashOp(SETTINGS_FLASH_OFFSET, page, FLASH_PAGE_SIZE)) {
+        return false;
+    }
+
+    // Read back through XIP to confirm the write landed
+    bool ok = memcmp((const void*)(XIP_BASE + SETTINGS_FLASH_OFFSET),
+                     &_block, sizeof(_block)) == 0;
+    _loaded = ok;
+    return ok;
+}
+
+bool Settings::isLoaded() const {
+    return _loaded;
+}
+
+const SettingsBlock& Settings::data() const {
+    return _block;
+}
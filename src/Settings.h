@@ -0,0 +1,101 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include <stdint.h>
+#include "Config.h"
+
+/**
+ * @brief Flash-persisted calibration and configuration block
+ *
+ * On-flash layout - fields are flat (no nested structs) so the format
+ * stays stable even if the in-RAM parameter structs change shape.
+ * Settings::save() stamps the header and CRC; callers fill the rest.
+ */
+struct SettingsBlock {
+    uint32_t magic;             // Block identifier ("CFGS")
+    uint16_t version;           // Layout version
+    uint16_t length;            // sizeof(SettingsBlock) when written
+
+    // Load cell calibration
+    float calibrationFactor;    // Raw counts per Newton, primary channel
+    int32_t offset;             // Tare offset, primary channel
+    float calibrationFactor2;   // Channel 2 (dual-channel mode)
+    int32_t offset2;            // Channel-2 tare offset
+
+    // NAU7802 AFE calibration registers, captured after a successful
+    // internal calibration so boot can restore them instead of
+    // re-running the calibration cycle
+    uint8_t afeOcal[3];         // OCAL1_B2..B0
+    uint8_t afeGcal[4];         // GCAL1_B3..B0
+    uint8_t afeValid;           // Nonzero if the AFE registers are usable
+    uint8_t stopOnBreak;
+    uint8_t reserved[3];
+
+    // Test parameters
+    float speed;                // Test speed (mm/s)
+    float maxForce;             // Maximum force limit (N)
+    float maxExtension;         // Maximum extension limit (mm)
+    uint32_t sampleRate;        // Data sample period (ms)
+    float breakThreshold;       // Force drop fraction for break detection
+
+    uint32_t crc;               // CRC-32 over everything above
+};
+
+/**
+ * @brief Flash persistence for calibration and test configuration
+ *
+ * Keeps one flash sector (SETTINGS_FLASH_OFFSET) holding a single
+ * SettingsBlock. load() is a validated read from memory-mapped flash -
+ * microseconds at boot, no I2C or ADC traffic - so a machine with a
+ * saved block comes up test-ready without the operator re-sending
+ * calibration and parameters every power cycle. save() (the SAVE
+ * command) erases and reprograms the sector through
+ * flash_safe_execute(), same as the capture path.
+ */
+class Settings {
+public:
+    /**
+     * @brief Construct a new Settings object
+     */
+    Settings();
+
+    /**
+     * @brief Read and validate the block from flash
+     *
+     * Checks magic, version, length and CRC; on success the block is
+     * available from data().
+     *
+     * @return true if a valid block was found
+     */
+    bool load();
+
+    /**
+     * @brief Write a block to the settings sector
+     *
+     * Stamps magic, version, length and CRC, then erases and programs
+     * the sector. Parks both cores for the ~45ms erase - never call
+     * while a test is running.
+     *
+     * @param block Field values to persist (header/CRC ignored)
+     * @return true if the block was written and verifies
+     */
+    bool save(const SettingsBlock& block);
+
+    /**
+     * @brief Check if load() found a valid block
+     * @return true if persisted settings are available
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief Get the loaded (or last saved) block
+     * @return Reference to the settings block
+     */
+    const SettingsBlock& data() const;
+
+private:
+    SettingsBlock _block;
+    bool _loaded;
+};
+
+#endif // SETTINGS_H
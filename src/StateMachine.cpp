@@ -1,23 +1,61 @@
 #include "StateMachine.h"
+#include "GpioIrq.h"
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
-#include <cmath>
+#include <stdio.h>
 
-StateMachine::StateMachine(LoadCell& loadCell, Stepper& stepper, Protocol& protocol)
+// E-stop latch, set in the GPIO ISR the moment the button edge lands.
+// The ISR also de-energizes the driver directly, so worst-case stop
+// latency is interrupt latency, not a main-loop iteration.
+static volatile bool s_estopLatched = false;
+
+static void estopIrqHandler(uint gpio, uint32_t events) {
+    (void)gpio;
+    if (events & GPIO_IRQ_EDGE_FALL) {      // Button is active LOW
+        s_estopLatched = true;
+        gpio_put(STEPPER_ENABLE_PIN, true); // DM542T: HIGH = disabled
+    }
+}
+
+StateMachine::StateMachine(LoadCell& loadCell, Stepper& stepper, PulseEngine& pulseEngine,
+                           Protocol& protocol, Capture& capture, Settings& settings)
     : _loadCell(loadCell)
     , _stepper(stepper)
+    , _pulseEngine(pulseEngine)
     , _protocol(protocol)
+    , _capture(capture)
+    , _settings(settings)
     , _state(State::IDLE)
     , _previousState(State::IDLE)
+    , _testMode(TestMode::PULL)
+    , _holdForceN(0)
+    , _strainRate(0)
+    , _lastControlSample(0)
     , _lastSampleTime(0)
     , _testStartTime(0)
     , _lastStatusTime(0)
     , _stateEntryTime(0)
-    , _peakForce(0)
+    , _peakRaw(0)
     , _extensionAtPeak(0)
     , _startPosition(0)
     , _jogActive(false)
     , _jogDirection(Direction::UP)
+    , _rawOffset(0)
+    , _maxForceRaw(0)
+    , _breakKeepQ15(16384)
+    , _minBreakRaw(0)
+    , _forceChangeRaw(0)
+    , _slopeRatioQ15(0)
+    , _dropKeepQ15(32768)
+    , _dropFloorRaw(0)
+    , _slopeFloorRaw(0)
+    , _lastSampledRaw(0)
+    , _lastSlopeRaw(0)
+    , _maxRawSeen(0)
+    , _lastCaptureSample(0)
+    , _pretrigHead(0)
+    , _pretrigCount(0)
+    , _tarePending(false)
     , _emergencyStopActive(false)
     , _emergencyStopPin(EMERGENCY_STOP_PIN)
 {
@@ -28,16 +66,22 @@ StateMachine::StateMachine(LoadCell& loadCell, Stepper& stepper, Protocol& proto
     _params.sampleRate = SAMPLE_RATE_MS;
     _params.stopOnBreak = true;
     _params.breakThreshold = 0.5f;  // 50% drop
+    _params.eventForceDelta = EVENT_FORCE_DELTA_N;
+    _params.eventSlopeRatio = EVENT_SLOPE_RATIO;
+    _params.eventDropRatio = EVENT_DROP_RATIO;
+    _params.eventMinGapMs = EVENT_MIN_GAP_MS;
     
     resetTestResult();
 }
 
 void StateMachine::begin() {
-    // Setup emergency stop pin
+    // Setup emergency stop pin - the falling edge latches in the ISR,
+    // update() consumes the latch and runs the full shutdown path
     gpio_init(_emergencyStopPin);
     gpio_set_dir(_emergencyStopPin, GPIO_IN);
     gpio_pull_up(_emergencyStopPin);
-    
+    gpioIrqRegister(_emergencyStopPin, GPIO_IRQ_EDGE_FALL, estopIrqHandler);
+
     // Setup indicator LEDs
     gpio_init(LED_STATUS_PIN);
     gpio_init(LED_ERROR_PIN);
@@ -46,7 +90,21 @@ void StateMachine::begin() {
     
     gpio_put(LED_STATUS_PIN, false);
     gpio_put(LED_ERROR_PIN, false);
-    
+
+    // Apply persisted test parameters through the range-checked setters
+    // (calibration was restored before begin(), in setup())
+    if (_settings.isLoaded()) {
+        const SettingsBlock& s = _settings.data();
+        setTestSpeed(s.speed);
+        setMaxForce(s.maxForce);
+        setMaxExtension(s.maxExtension);
+        setSampleRate(s.sampleRate);
+        _params.stopOnBreak = s.stopOnBreak != 0;
+        if (s.breakThreshold > 0.0f && s.breakThreshold < 1.0f) {
+            _params.breakThreshold = s.breakThreshold;
+        }
+    }
+
     setState(State::IDLE);
 }
 
@@ -59,12 +117,16 @@ void StateMachine::update() {
     
     // Read current sensor values
     _loadCell.readForce();
-    
-    // Run stepper if needed
-    if (_stepper.isEnabled()) {
-        _stepper.run();
+
+    // Report async tare completion - the accumulation itself happened
+    // inside readForce() without ever blocking this loop
+    if (_tarePending && !_loadCell.isAsyncBusy()) {
+        _tarePending = false;
+        _protocol.sendOK("Tared");
     }
-    
+
+    // Stepping runs on core 1 (PulseEngine) - nothing to poll here
+
     // Update based on current state
     switch (_state) {
         case State::IDLE:
@@ -130,13 +192,51 @@ void StateMachine::handleCommand(Command cmd) {
     
     switch (cmd) {
         case Command::START_TEST:
+            _testMode = TestMode::PULL;
             if (startTest()) {
                 _protocol.sendOK("Test started");
             } else {
                 _protocol.sendError(ResponseStatus::ERROR_NOT_READY);
             }
             break;
-            
+
+        case Command::START_HOLD_FORCE:
+            if (!_protocol.hasParameter() || param <= 0 || param > _params.maxForce) {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM,
+                                    "HOLD needs force in N, below MAXFORCE");
+                break;
+            }
+            _testMode = TestMode::HOLD_FORCE;
+            _holdForceN = param;
+            if (startTest()) {
+                _protocol.sendOK("Force hold started");
+            } else {
+                _testMode = TestMode::PULL;
+                _protocol.sendError(ResponseStatus::ERROR_NOT_READY);
+            }
+            break;
+
+        case Command::START_STRAIN_RATE:
+            if (!_protocol.hasParameter() || param <= 0 || param > STRAIN_RATE_MAX) {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM,
+                                    "STRAINRATE needs rate in 1/s");
+                break;
+            }
+            if (_analytics.getGaugeLength() <= 0.0f) {
+                // v = rate x length needs a nonzero starting length
+                _protocol.sendError(ResponseStatus::ERROR_NOT_READY, "Set GAUGE first");
+                break;
+            }
+            _testMode = TestMode::STRAIN_RATE;
+            _strainRate = param;
+            if (startTest()) {
+                _protocol.sendOK("Strain-rate test started");
+            } else {
+                _testMode = TestMode::PULL;
+                _protocol.sendError(ResponseStatus::ERROR_NOT_READY);
+            }
+            break;
+
         case Command::STOP_TEST:
             stopTest();
             _protocol.sendOK("Test stopped");
@@ -169,7 +269,7 @@ void StateMachine::handleCommand(Command cmd) {
             
         case Command::MOVE_TO:
             if (_protocol.hasParameter()) {
-                _stepper.moveToMm(param);
+                _pulseEngine.moveToMm(param);
                 _protocol.sendOK();
             } else {
                 _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM);
@@ -225,9 +325,101 @@ void StateMachine::handleCommand(Command cmd) {
             }
             break;
             
+        case Command::SET_EVENT_DELTA:
+            if (_protocol.hasParameter() && param > 0 && param <= LOADCELL_MAX_FORCE) {
+                _params.eventForceDelta = param;
+                _protocol.sendOK();
+            } else {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM);
+            }
+            break;
+
+        case Command::SET_EVENT_SLOPE:
+            if (_protocol.hasParameter() && param > 0 && param <= 10.0f) {
+                _params.eventSlopeRatio = param;
+                _protocol.sendOK();
+            } else {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM);
+            }
+            break;
+
+        case Command::SET_EVENT_DROP:
+            if (_protocol.hasParameter() && param > 0 && param < 1.0f) {
+                _params.eventDropRatio = param;
+                _protocol.sendOK();
+            } else {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM);
+            }
+            break;
+
+        case Command::SET_EVENT_GAP:
+            if (_protocol.hasParameter() && param >= 1 && param <= 10000) {
+                _params.eventMinGapMs = (uint32_t)param;
+                _protocol.sendOK();
+            } else {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM);
+            }
+            break;
+
+        case Command::SET_AREA:
+            if (_protocol.hasParameter() && param > 0) {
+                _analytics.setArea(param);
+                _protocol.sendOK();
+            } else {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM);
+            }
+            break;
+
+        case Command::SET_GAUGE:
+            if (_protocol.hasParameter() && param > 0) {
+                _analytics.setGaugeLength(param);
+                _protocol.sendOK();
+            } else {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM);
+            }
+            break;
+
+        case Command::GET_ANALYSIS:
+            _protocol.sendAnalysis(_analytics.modulus(),
+                                   _analytics.energy(),
+                                   _analytics.sampleCount());
+            break;
+
+        case Command::SET_HISPEED:
+            // "HISPEED" or "HISPEED n" enables 320 SPS with boxcar
+            // length n; "HISPEED 0" returns to the normal rate
+            if (_protocol.hasParameter() && param == 0) {
+                _loadCell.setHighSpeedMode(false);
+                _protocol.sendOK("High-speed mode off");
+            } else {
+                uint8_t decim = _protocol.hasParameter() ?
+                                (uint8_t)param : HISPEED_DECIMATION;
+                _loadCell.setHighSpeedMode(true, decim);
+                _protocol.sendOK("High-speed mode on");
+            }
+            break;
+
+        case Command::SET_DUAL_CHANNEL:
+            // "DUAL" or "DUAL 1" interleaves channel 2 into the sample
+            // stream; "DUAL 0" returns to single-channel acquisition
+            if (_protocol.hasParameter() && param == 0) {
+                _loadCell.setDualChannelMode(false);
+                _protocol.sendOK("Dual channel off");
+            } else {
+                _loadCell.setDualChannelMode(true);
+                _protocol.sendOK("Dual channel on");
+            }
+            break;
+
         case Command::TARE:
-            tare();
-            _protocol.sendOK("Tared");
+            // Non-blocking: accumulation rides along with the normal
+            // sample stream, completion is reported from update()
+            if (_loadCell.isAsyncBusy()) {
+                _protocol.sendError(ResponseStatus::ERROR_BUSY, "Tare in progress");
+            } else {
+                tare();
+                _protocol.sendOK("Tare started");
+            }
             break;
             
         case Command::CALIBRATE:
@@ -252,9 +444,18 @@ void StateMachine::handleCommand(Command cmd) {
                 isTestActive()
             );
             break;
-            
+
+        case Command::GET_STATS:
+            _protocol.sendStats();
+            break;
+
         case Command::GET_FORCE:
-            _protocol.sendForce(getCurrentForce());
+            if (_loadCell.isDualChannelMode()) {
+                _protocol.sendDualForce(getCurrentForce(),
+                                        _loadCell.getSecondaryForce());
+            } else {
+                _protocol.sendForce(getCurrentForce());
+            }
             break;
             
         case Command::GET_POSITION:
@@ -279,7 +480,66 @@ void StateMachine::handleCommand(Command cmd) {
         case Command::IDENTIFY:
             _protocol.sendIdentity();
             break;
-            
+
+        case Command::DUMP_CAPTURE:
+            if (_state == State::RUNNING) {
+                _protocol.sendError(ResponseStatus::ERROR_BUSY, "Test running");
+            } else {
+                _capture.dump();
+            }
+            break;
+
+        case Command::SET_BINARY_MODE: {
+            // "BINMODE" or "BINMODE 1" = binary frames, "BINMODE 0" =
+            // ASCII, "BINMODE 2" = delta encoding. Acknowledge before
+            // switching so the OK is always ASCII.
+            int32_t mode = _protocol.hasParameter() ?
+                           _protocol.getIntParameter() : 1;
+            if (mode < 0 || mode > 2) {
+                _protocol.sendError(ResponseStatus::ERROR_INVALID_PARAM,
+                                    "Mode must be 0, 1 or 2");
+                break;
+            }
+            _protocol.sendOK(mode == 0 ? "Binary mode off" :
+                             mode == 1 ? "Binary mode on" : "Delta mode on");
+            _protocol.setEncoding((DataEncoding)mode);
+            break;
+        }
+
+        case Command::SAVE_CONFIG: {
+            // The sector erase parks both cores for ~45ms - refuse
+            // while a test is collecting samples
+            if (_state == State::RUNNING || _state == State::PAUSED) {
+                _protocol.sendError(ResponseStatus::ERROR_BUSY,
+                                    "Cannot save during test");
+                break;
+            }
+
+            SettingsBlock block = {};
+            block.calibrationFactor = _loadCell.getCalibrationFactor();
+            block.offset = _loadCell.getOffset();
+            block.calibrationFactor2 = _loadCell.getSecondaryCalibrationFactor();
+            block.offset2 = _loadCell.getSecondaryOffset();
+            block.afeValid = _loadCell.afeCalibrationOk() ? 1 : 0;
+            if (block.afeValid) {
+                _loadCell.getAfeCalibration(block.afeOcal, block.afeGcal);
+            }
+            block.speed = _params.speed;
+            block.maxForce = _params.maxForce;
+            block.maxExtension = _params.maxExtension;
+            block.sampleRate = _params.sampleRate;
+            block.stopOnBreak = _params.stopOnBreak ? 1 : 0;
+            block.breakThreshold = _params.breakThreshold;
+
+            if (_settings.save(block)) {
+                _protocol.sendOK("Config saved");
+            } else {
+                _protocol.sendError(ResponseStatus::ERROR_BUSY,
+                                    "Flash write failed");
+            }
+            break;
+        }
+
         case Command::UNKNOWN:
         default:
             _protocol.sendError(ResponseStatus::ERROR_UNKNOWN_CMD);
@@ -324,7 +584,7 @@ const TestResult& StateMachine::getTestResult() const {
 void StateMachine::setTestSpeed(float speed) {
     if (speed > 0 && speed <= 100.0f) {
         _params.speed = speed;
-        _stepper.setSpeedMmPerSec(speed);
+        _pulseEngine.setSpeedMmPerSec(speed);
     }
 }
 
@@ -355,16 +615,48 @@ bool StateMachine::startTest() {
     resetTestResult();
     _testStartTime = to_ms_since_boot(get_absolute_time());
     _startPosition = getCurrentPosition();
-    _peakForce = 0;
     _extensionAtPeak = 0;
+
+    // Precompute raw-count thresholds so the per-sample checks in
+    // updateRunning() are pure integer compares
+    _rawOffset = _loadCell.getOffset();
+    _maxForceRaw = _loadCell.newtonsToRaw(_params.maxForce);
+    _breakKeepQ15 = (int32_t)((1.0f - _params.breakThreshold) * 32768.0f);
+    _minBreakRaw = _loadCell.newtonsToRawDelta(10.0f);
+    _forceChangeRaw = _loadCell.newtonsToRawDelta(_params.eventForceDelta);
+    _slopeRatioQ15 = (int32_t)(_params.eventSlopeRatio * 32768.0f);
+    _dropKeepQ15 = (int32_t)((1.0f - _params.eventDropRatio) * 32768.0f);
+    _dropFloorRaw = _loadCell.newtonsToRawDelta(EVENT_DROP_FLOOR_N);
+    _slopeFloorRaw = _loadCell.newtonsToRawDelta(EVENT_SLOPE_FLOOR_N_S) / 1000;
+
+    _peakRaw = _rawOffset;
+    _lastSampledRaw = _rawOffset;
+    _lastSlopeRaw = 0;
+    _maxRawSeen = _rawOffset;
+
+    // Prepare the flash capture region (erases before motion starts)
+    _capture.startCapture();
+    _lastCaptureSample = _loadCell.getSampleCount();
+
+    // Empty the pre-trigger ring so a break can't replay stale samples
+    _pretrigHead = 0;
+    _pretrigCount = 0;
+
+    // Fresh accumulators for the streaming modulus/energy estimates
+    _analytics.reset();
     
     // Configure stepper for test
-    _stepper.setSpeedMmPerSec(_params.speed);
-    _stepper.enable();
-    
-    // Start movement (tensile = upward)
-    _stepper.moveToMm(_params.maxExtension);
-    
+    _pulseEngine.setSpeedMmPerSec(_params.speed);
+    _pulseEngine.enable();
+
+    // Start movement (tensile = upward). Closed-loop modes skip the
+    // position move - the per-sample control law in updateRunning()
+    // owns motion through the velocity servo.
+    if (_testMode == TestMode::PULL) {
+        _pulseEngine.moveToMm(_params.maxExtension);
+    }
+    _lastControlSample = _lastCaptureSample;
+
     // Enable data streaming
     _protocol.setDataStreaming(true);
     
@@ -374,8 +666,9 @@ bool StateMachine::startTest() {
 
 void StateMachine::stopTest() {
     if (_state == State::RUNNING || _state == State::PAUSED) {
-        _stepper.stop();
+        _pulseEngine.stop();
         finalizeTest();
+        _capture.stopCapture();
         _protocol.setDataStreaming(false);
         setState(State::STOPPED);
     }
@@ -383,28 +676,29 @@ void StateMachine::stopTest() {
 
 void StateMachine::pauseTest() {
     if (_state == State::RUNNING) {
-        _stepper.stopSmooth();
+        _pulseEngine.stopSmooth();
         setState(State::PAUSED);
     }
 }
 
 void StateMachine::resumeTest() {
     if (_state == State::PAUSED) {
-        _stepper.moveToMm(_params.maxExtension);
+        _pulseEngine.moveToMm(_params.maxExtension);
         setState(State::RUNNING);
     }
 }
 
 void StateMachine::emergencyStop() {
     _emergencyStopActive = true;
-    _stepper.stop();
-    _stepper.disable();
+    _pulseEngine.stop();
+    _pulseEngine.disable();
     
     gpio_put(LED_ERROR_PIN, true);
     gpio_put(LED_STATUS_PIN, false);
     
     if (_state == State::RUNNING) {
         finalizeTest();
+        _capture.stopCapture();
         _protocol.setDataStreaming(false);
     }
     
@@ -412,7 +706,10 @@ void StateMachine::emergencyStop() {
 }
 
 void StateMachine::clearEmergency() {
-    if (_state == State::EMERGENCY && !checkEmergencyStop()) {
+    // Clear against the physical level, not the latch - the latch only
+    // releases once the button itself has been released
+    if (_state == State::EMERGENCY && gpio_get(_emergencyStopPin) != false) {
+        s_estopLatched = false;
         _emergencyStopActive = false;
         gpio_put(LED_ERROR_PIN, false);
         setState(State::IDLE);
@@ -424,13 +721,16 @@ bool StateMachine::startHoming() {
         return false;
     }
     
-    _stepper.enable();
+    _pulseEngine.enable();
+    _pulseEngine.startHoming(Direction::DOWN);
     setState(State::HOMING);
     return true;
 }
 
 void StateMachine::tare() {
-    _loadCell.tare();
+    if (_loadCell.tareAsync()) {
+        _tarePending = true;
+    }
 }
 
 void StateMachine::jog(Direction dir, float distance) {
@@ -439,33 +739,32 @@ void StateMachine::jog(Direction dir, float distance) {
     }
     
     if (!_stepper.isEnabled()) {
-        _stepper.enable();
+        _pulseEngine.enable();
     }
-    
+
     _jogActive = true;
     _jogDirection = dir;
-    
+
     if (distance > 0) {
         // Move specific distance
         if (dir == Direction::UP) {
-            _stepper.moveMm(distance);
+            _pulseEngine.moveMm(distance);
         } else {
-            _stepper.moveMm(-distance);
+            _pulseEngine.moveMm(-distance);
         }
     } else {
-        // Continuous movement
-        _stepper.setDirection(dir);
+        // Continuous movement - step() sets direction as it goes
         if (dir == Direction::UP) {
-            _stepper.moveTo(INT32_MAX / 2);
+            _pulseEngine.moveTo(INT32_MAX / 2);
         } else {
-            _stepper.moveTo(INT32_MIN / 2);
+            _pulseEngine.moveTo(INT32_MIN / 2);
         }
     }
 }
 
 void StateMachine::stopJog() {
     if (_jogActive) {
-        _stepper.stopSmooth();
+        _pulseEngine.stopSmooth();
         _jogActive = false;
     }
 }
@@ -494,14 +793,12 @@ void StateMachine::updateIdle() {
 }
 
 void StateMachine::updateHoming() {
-    static bool homingStarted = false;
-    
-    if (!homingStarted) {
-        if (_stepper.home(Direction::DOWN)) {
-            homingStarted = false;
+    // Homing runs on core 1 - poll until it reports completion so the
+    // main loop keeps serving commands and safety checks meanwhile
+    if (!_pulseEngine.isHomingActive()) {
+        if (_pulseEngine.homingSucceeded()) {
             setState(State::READY);
         } else {
-            homingStarted = false;
             setState(State::ERROR);
         }
     }
@@ -527,14 +824,33 @@ void StateMachine::updateRunning() {
         return;
     }
     
-    // Check force overload
-    float force = getCurrentForce();
-    if (force >= _params.maxForce || _loadCell.isOverload()) {
+    // Check force overload - integer compares against raw thresholds
+    int32_t raw = _loadCell.getLastRaw();
+
+    // Log every new ADC sample to the flash capture - full-rate record,
+    // independent of the (decimated) live stream below
+    uint32_t sampleCount = _loadCell.getSampleCount();
+    if (sampleCount != _lastCaptureSample) {
+        _lastCaptureSample = sampleCount;
+        uint32_t t = to_ms_since_boot(get_absolute_time()) - _testStartTime;
+        int32_t pos = _stepper.getCurrentPosition();
+        _capture.record(t, raw, pos);
+
+        // Same sample into the pre-trigger ring - plain array writes,
+        // always on, so the break edge is captured at full rate
+        _pretrigRing[_pretrigHead] = {t, raw, pos};
+        _pretrigHead = (_pretrigHead + 1) % PRETRIG_RING_SIZE;
+        if (_pretrigCount < PRETRIG_RING_SIZE) {
+            _pretrigCount++;
+        }
+    }
+
+    if (raw >= _maxForceRaw || _loadCell.isOverload()) {
         stopTest();
         _protocol.sendError(ResponseStatus::ERROR_OVERLOAD, "Force limit exceeded");
         return;
     }
-    
+
     // Check extension limit
     float extension = getCurrentPosition() - _startPosition;
     if (extension >= _params.maxExtension) {
@@ -542,62 +858,104 @@ void StateMachine::updateRunning() {
         _protocol.sendOK("Extension limit reached");
         return;
     }
-    
-    // Track peak force
-    if (force > _peakForce) {
-        _peakForce = force;
+
+    // Track peak force (raw counts)
+    if (raw > _peakRaw) {
+        _peakRaw = raw;
         _extensionAtPeak = extension;
     }
-    
+
     // Check for specimen break
     if (_params.stopOnBreak && detectBreak()) {
         _result.specimenBroke = true;
-        _result.breakForce = force;
+        _result.breakForce = _loadCell.rawToNewtons(raw);
         _result.breakExtension = extension;
         stopTest();
         _protocol.sendOK("Specimen break detected");
+        emitPretrigger();
         return;
     }
-    
-    // Check if movement complete
-    if (!_stepper.isMoving()) {
+
+    // Check if movement complete (PULL only - the closed-loop modes sit
+    // still whenever the control law commands zero speed, and only end
+    // on STOP, a limit, or a break)
+    if (_testMode == TestMode::PULL && !_stepper.isMoving()) {
         _result.completed = true;
         stopTest();
         _protocol.sendOK("Test completed");
         return;
     }
-    
+
+    // Closed-loop control law - once per new ADC sample (80 Hz), so the
+    // correction rate tracks the force feed, not the loop() rate
+    if (_testMode != TestMode::PULL && sampleCount != _lastControlSample) {
+        _lastControlSample = sampleCount;
+        float v;
+        if (_testMode == TestMode::HOLD_FORCE) {
+            // Proportional on force error, deadband against ADC noise
+            float error = _holdForceN - _loadCell.rawToNewtons(raw);
+            if (error > -HOLD_FORCE_DEADBAND_N && error < HOLD_FORCE_DEADBAND_N) {
+                error = 0;
+            }
+            v = HOLD_FORCE_KP * error;
+            if (v > _params.speed)  v = _params.speed;
+            if (v < -_params.speed) v = -_params.speed;
+        } else {
+            // True strain rate: v = rate x current specimen length
+            v = _strainRate * (_analytics.getGaugeLength() + extension);
+            if (v > _params.speed) v = _params.speed;
+        }
+        _pulseEngine.setServoSpeedMmPerSec(v);
+    }
+
     // === HYBRID SAMPLING: Time-based + Event-based ===
+    // All event math runs on raw ADC counts - ratios become int64
+    // cross-multiplications instead of soft-float divides
     uint32_t now = to_ms_since_boot(get_absolute_time());
     uint32_t timeSinceLast = now - _lastSampleTime;
-    
-    // Event detection
-    static float lastSampledForce = 0;
-    static float lastSlope = 0;
-    static float maxForceSeen = 0;
-    
-    // Calculate force rate (slope)
-    float dt = timeSinceLast / 1000.0f;
-    float currentSlope = (dt > 0) ? (force - lastSampledForce) / dt : 0;
-    
-    // Event flags
+
+    int32_t rawDelta = raw - _lastSampledRaw;
+    int32_t absDelta = rawDelta >= 0 ? rawDelta : -rawDelta;
+
+    // Force rate in raw counts per millisecond
+    int32_t slope = (timeSinceLast > 0) ? rawDelta / (int32_t)timeSinceLast : 0;
+    int32_t absLastSlope = _lastSlopeRaw >= 0 ? _lastSlopeRaw : -_lastSlopeRaw;
+    int32_t slopeDiff = slope - _lastSlopeRaw;
+    int32_t absSlopeDiff = slopeDiff >= 0 ? slopeDiff : -slopeDiff;
+
+    // Event flags against the per-test thresholds, all precomputed to
+    // raw counts / Q15 in startTest() - evaluation stays integer-only,
+    // cheap enough for the full ADC rate
     bool timeBasedSample = (timeSinceLast >= _params.sampleRate);
-    bool forceChangeEvent = (fabsf(force - lastSampledForce) > 5.0f);  // 5N threshold
-    bool slopeChangeEvent = (fabsf(lastSlope) > 1.0f && 
-                            fabsf(currentSlope - lastSlope) / fabsf(lastSlope) > 0.3f);
-    bool peakEvent = (force > maxForceSeen && force > maxForceSeen * 0.99f);
-    bool forceDropEvent = (maxForceSeen > 50.0f && force < maxForceSeen * 0.9f);
-    
-    bool eventBasedSample = (timeSinceLast >= 20) &&  // Min 20ms between samples
+    bool forceChangeEvent = (absDelta > _forceChangeRaw);
+    bool slopeChangeEvent = (absLastSlope > _slopeFloorRaw &&
+                             (int64_t)absSlopeDiff * 32768 >
+                             (int64_t)absLastSlope * _slopeRatioQ15);
+    bool peakEvent = (raw > _maxRawSeen);
+    bool forceDropEvent = (_maxRawSeen - _rawOffset > _dropFloorRaw &&
+                           (int64_t)(raw - _rawOffset) * 32768 <
+                           (int64_t)(_maxRawSeen - _rawOffset) * _dropKeepQ15);
+
+    bool eventBasedSample = (timeSinceLast >= _params.eventMinGapMs) &&
                            (forceChangeEvent || slopeChangeEvent || peakEvent || forceDropEvent);
-    
+
     if (timeBasedSample || eventBasedSample) {
         recordDataPoint();
         _lastSampleTime = now;
-        lastSampledForce = force;
-        lastSlope = currentSlope;
-        if (force > maxForceSeen) {
-            maxForceSeen = force;
+        _lastSampledRaw = raw;
+        _lastSlopeRaw = slope;
+        if (raw > _maxRawSeen) {
+            _maxRawSeen = raw;
+        }
+
+        // Attribute the sample - every trigger that fired is counted,
+        // so the EVENTS breakdown shows what the thresholds are doing
+        if (timeBasedSample) _result.timeSamples++;
+        if (eventBasedSample) {
+            if (forceChangeEvent) _result.forceEvents++;
+            if (slopeChangeEvent) _result.slopeEvents++;
+            if (peakEvent)        _result.peakEvents++;
+            if (forceDropEvent)   _result.dropEvents++;
         }
     }
 }
@@ -626,11 +984,11 @@ void StateMachine::updateEmergency() {
 bool StateMachine::checkSafety() {
     // Check limit switches
     if (_stepper.isAtTopLimit() && _stepper.getDirection() == Direction::UP) {
-        _stepper.stop();
+        _pulseEngine.stop();
         return false;
     }
     if (_stepper.isAtBottomLimit() && _stepper.getDirection() == Direction::DOWN) {
-        _stepper.stop();
+        _pulseEngine.stop();
         return false;
     }
     
@@ -638,16 +996,19 @@ bool StateMachine::checkSafety() {
 }
 
 bool StateMachine::checkEmergencyStop() {
-    return gpio_get(_emergencyStopPin) == false;  // Active LOW
+    // Latched by the ISR so a press between polls is never missed;
+    // also sample the level for a button still held down
+    return s_estopLatched || gpio_get(_emergencyStopPin) == false;  // Active LOW
 }
 
 bool StateMachine::detectBreak() {
-    if (_peakForce < 10.0f) return false;  // Minimum force before break detection
-    
-    float currentForce = getCurrentForce();
-    float dropRatio = 1.0f - (currentForce / _peakForce);
-    
-    return dropRatio > _params.breakThreshold;
+    int32_t peakDelta = _peakRaw - _rawOffset;
+    if (peakDelta < _minBreakRaw) return false;  // Minimum force before break detection
+
+    // Break when current force falls below (1 - breakThreshold) of the
+    // peak. Fixed-point: compare current << 15 against peak * keepQ15.
+    int32_t currentDelta = _loadCell.getLastRaw() - _rawOffset;
+    return ((int64_t)currentDelta << 15) < (int64_t)peakDelta * _breakKeepQ15;
 }
 
 void StateMachine::recordDataPoint() {
@@ -657,14 +1018,37 @@ void StateMachine::recordDataPoint() {
     packet.timestamp = now - _testStartTime;
     packet.force = getCurrentForce();
     packet.extension = getCurrentPosition() - _startPosition;
-    packet.stress = 0;  // Would need specimen dimensions
-    packet.strain = 0;  // Would need gauge length
-    
+
+    // Feed the streaming analytics and report stress/strain with the
+    // sample - zeros if the operator never set the specimen geometry
+    _analytics.addSample(packet.force, packet.extension);
+    packet.stress = _analytics.stress(packet.force);
+    packet.strain = _analytics.strain(packet.extension);
+
     _result.dataPoints++;
-    
+
     if (_protocol.isDataStreaming()) {
-        _protocol.sendData(packet);
+        // O(1) enqueue - the ring is drained in batches from loop(),
+        // so a stalled host can never block the control path here
+        _protocol.queueData(packet);
+    }
+}
+
+void StateMachine::emitPretrigger() {
+    // Enqueued on the TX ring like every other response, so the replay
+    // lands after the break OK and any queued DATA frames - a raw
+    // printf here would jump the queue and splice into a half-drained
+    // frame in the CDC FIFO
+    _protocol.sendPretrigStart(_pretrigCount);
+
+    uint8_t idx = (_pretrigHead + PRETRIG_RING_SIZE - _pretrigCount) % PRETRIG_RING_SIZE;
+    for (uint8_t i = 0; i < _pretrigCount; i++) {
+        const CaptureRecord& rec = _pretrigRing[idx];
+        _protocol.sendPretrigRecord(rec.timestamp, rec.rawForce, rec.position);
+        idx = (idx + 1) % PRETRIG_RING_SIZE;
     }
+
+    _protocol.sendPretrigEnd();
 }
 
 void StateMachine::resetTestResult() {
@@ -674,12 +1058,26 @@ void StateMachine::resetTestResult() {
     _result.breakExtension = 0;
     _result.duration = 0;
     _result.dataPoints = 0;
+    _result.modulus = 0;
+    _result.energy = 0;
     _result.completed = false;
     _result.specimenBroke = false;
+    _result.timeSamples = 0;
+    _result.forceEvents = 0;
+    _result.slopeEvents = 0;
+    _result.peakEvents = 0;
+    _result.dropEvents = 0;
 }
 
 void StateMachine::finalizeTest() {
-    _result.maxForce = _peakForce;
+    _result.maxForce = _loadCell.rawToNewtons(_peakRaw);
     _result.maxExtension = _extensionAtPeak;
     _result.duration = to_ms_since_boot(get_absolute_time()) - _testStartTime;
+    _result.modulus = _analytics.modulus();
+    _result.energy = _analytics.energy();
+
+    // Let the host see which triggers drove the samples this test
+    _protocol.sendSampleEvents(_result.timeSamples, _result.forceEvents,
+                               _result.slopeEvents, _result.peakEvents,
+                               _result.dropEvents);
 }
@@ -5,7 +5,11 @@
 #include "Config.h"
 #include "LoadCell.h"
 #include "Stepper.h"
+#include "PulseEngine.h"
 #include "Protocol.h"
+#include "Capture.h"
+#include "Settings.h"
+#include "Analytics.h"
 
 /**
  * @brief Machine states enumeration
@@ -31,8 +35,33 @@ struct TestResult {
     float breakExtension;   // Extension at break (mm)
     uint32_t duration;      // Test duration (ms)
     uint32_t dataPoints;    // Number of data points recorded
+    float modulus;          // Elastic modulus estimate (MPa, 0 if no geometry)
+    float energy;           // Energy under force-extension curve (J)
     bool completed;         // Test completed normally
     bool specimenBroke;     // Specimen failure detected
+
+    // Adaptive-sampling breakdown - which triggers drove the samples,
+    // so the EV* thresholds can be tuned from real test data
+    uint32_t timeSamples;   // Samples taken on the periodic tick
+    uint32_t forceEvents;   // Force-change events fired
+    uint32_t slopeEvents;   // Slope-change events fired
+    uint32_t peakEvents;    // New-peak events fired
+    uint32_t dropEvents;    // Drop-from-peak events fired
+};
+
+/**
+ * @brief Control mode for the active test
+ *
+ * PULL is the classic open-loop tensile pull to maxExtension. The
+ * closed-loop modes drive the stepper's velocity servo from the force
+ * feed: HOLD_FORCE regulates to a force setpoint (creep testing),
+ * STRAIN_RATE scales crosshead speed with current specimen length so
+ * true strain rate stays constant as the specimen extends.
+ */
+enum class TestMode : uint8_t {
+    PULL = 0,       // Constant-speed pull (open loop)
+    HOLD_FORCE,     // Closed-loop force hold
+    STRAIN_RATE     // Closed-loop constant true strain rate
 };
 
 /**
@@ -45,6 +74,14 @@ struct TestParameters {
     uint32_t sampleRate;    // Sample rate (ms)
     bool stopOnBreak;       // Stop test if specimen breaks
     float breakThreshold;   // Force drop % to detect break
+
+    // Adaptive-sampling thresholds (EVDELTA/EVSLOPE/EVDROP/EVGAP) -
+    // tuned per material class; dense near fracture for brittle
+    // specimens, sparse steady state for hour-long elastomer tests
+    float eventForceDelta;  // Force change that forces a sample (N)
+    float eventSlopeRatio;  // Fractional slope change that forces a sample
+    float eventDropRatio;   // Fractional drop from peak that forces a sample
+    uint32_t eventMinGapMs; // Minimum spacing between event samples (ms)
 };
 
 /**
@@ -59,9 +96,13 @@ public:
      * @brief Construct a new StateMachine object
      * @param loadCell Reference to LoadCell instance
      * @param stepper Reference to Stepper instance
+     * @param pulseEngine Reference to core-1 PulseEngine instance
      * @param protocol Reference to Protocol instance
+     * @param capture Reference to flash Capture instance
+     * @param settings Reference to flash Settings instance
      */
-    StateMachine(LoadCell& loadCell, Stepper& stepper, Protocol& protocol);
+    StateMachine(LoadCell& loadCell, Stepper& stepper, PulseEngine& pulseEngine,
+                 Protocol& protocol, Capture& capture, Settings& settings);
 
     /**
      * @brief Initialize the state machine
@@ -177,7 +218,7 @@ public:
     bool startHoming();
 
     /**
-     * @brief Tare the load cell
+     * @brief Start an asynchronous load cell tare
      */
     void tare();
 
@@ -208,26 +249,64 @@ public:
 private:
     LoadCell& _loadCell;
     Stepper& _stepper;
+    PulseEngine& _pulseEngine;
     Protocol& _protocol;
-    
+    Capture& _capture;
+    Settings& _settings;
+    Analytics _analytics;   // Streaming stress/strain/modulus/energy
+
     State _state;
     State _previousState;
     
     TestParameters _params;
     TestResult _result;
-    
+
+    // Closed-loop control state (HOLD/STRAINRATE commands)
+    TestMode _testMode;             // Control law for the active test
+    float _holdForceN;              // HOLD_FORCE setpoint (N)
+    float _strainRate;              // STRAIN_RATE setpoint (1/s)
+    uint32_t _lastControlSample;    // LoadCell sample count last serviced
+
     // Timing
     uint32_t _lastSampleTime;
     uint32_t _testStartTime;
     uint32_t _lastStatusTime;
     uint32_t _stateEntryTime;
     
-    // Test data tracking
-    float _peakForce;
+    // Test data tracking - force values are tracked in raw ADC counts
+    // so the per-sample hot path stays fixed-point (no FPU on the M0+);
+    // conversion to Newtons happens once, at the protocol boundary
+    int32_t _peakRaw;           // Peak raw counts this test
     float _extensionAtPeak;
     float _startPosition;
     bool _jogActive;
     Direction _jogDirection;
+
+    // Precomputed raw-count thresholds, refreshed in startTest()
+    int32_t _rawOffset;         // Load cell zero offset at test start
+    int32_t _maxForceRaw;       // _params.maxForce in raw counts
+    int32_t _breakKeepQ15;      // (1 - breakThreshold) in Q15
+    int32_t _minBreakRaw;       // Min peak delta before break detection
+    int32_t _forceChangeRaw;    // eventForceDelta in raw counts
+    int32_t _slopeRatioQ15;     // eventSlopeRatio in Q15
+    int32_t _dropKeepQ15;       // (1 - eventDropRatio) in Q15
+    int32_t _dropFloorRaw;      // Drop-event floor in raw counts
+    int32_t _slopeFloorRaw;     // Slope-event floor in counts/ms
+
+    // Event-sampling state, reset per test
+    int32_t _lastSampledRaw;
+    int32_t _lastSlopeRaw;      // Raw counts per ms at last sample
+    int32_t _maxRawSeen;
+    uint32_t _lastCaptureSample;    // LoadCell sample count last captured
+
+    // Pre-trigger ring: the last PRETRIG_RING_SIZE full-rate samples,
+    // emitted when detectBreak() fires so the host gets the fracture
+    // edge at ADC resolution instead of the streaming rate
+    CaptureRecord _pretrigRing[PRETRIG_RING_SIZE];
+    uint8_t _pretrigHead;       // Next write slot
+    uint8_t _pretrigCount;      // Valid entries (saturates at ring size)
+
+    bool _tarePending;          // Async tare running, OK sent on finish
     
     // Safety
     bool _emergencyStopActive;
@@ -302,6 +381,14 @@ private:
      */
     void recordDataPoint();
 
+    /**
+     * @brief Emit the pre-trigger ring after a break event
+     *
+     * Replays the samples leading up to the break, oldest first, as
+     * "PT timestamp,raw,position" lines bracketed by PRETRIG START/END.
+     */
+    void emitPretrigger();
+
     /**
      * @brief Reset test result structure
      */
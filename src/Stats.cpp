@@ -0,0 +1,44 @@
+#include "Stats.h"
+#include <string.h>
+
+static ChannelStats s_channels[(int)StatChannel::CHANNEL_COUNT];
+
+static const char* const s_channelNames[(int)StatChannel::CHANNEL_COUNT] = {
+    "LOOP",
+    "INPUT",
+    "UPDATE",
+    "DRAIN",
+    "I2C",
+    "STEP",
+};
+
+void statsRecord(StatChannel channel, uint32_t us) {
+    ChannelStats& ch = s_channels[(int)channel];
+
+    ch.count++;
+    ch.sumUs += us;
+    if (us > ch.maxUs) {
+        ch.maxUs = us;
+    }
+
+    // Power-of-two bucket: shift until the value fits, clamp at the top
+    uint32_t v = us;
+    uint8_t bucket = 0;
+    while (v > 1 && bucket < STATS_HIST_BUCKETS - 1) {
+        v >>= 1;
+        bucket++;
+    }
+    ch.hist[bucket]++;
+}
+
+const ChannelStats& statsGet(StatChannel channel) {
+    return s_channels[(int)channel];
+}
+
+const char* statsChannelName(StatChannel channel) {
+    return s_channelNames[(int)channel];
+}
+
+void statsReset(void) {
+    memset(s_channels, 0, sizeof(s_channels));
+}
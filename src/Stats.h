@@ -0,0 +1,73 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include "Config.h"
+
+/**
+ * @brief Hot-path timing instrumentation
+ *
+ * Free-function module (like SerialTx/GpioIrq) that accumulates
+ * microsecond deltas from the main-loop stages, the per-sample I2C
+ * transaction and the core-1 step ISR into per-channel counters: count,
+ * sum, high-water mark and a power-of-two histogram. Recording is a
+ * handful of integer ops on file statics - safe from ISR context and
+ * cheap enough to leave on in production, which is the point: when a
+ * field machine stutters, STATS says whether the time went to USB, the
+ * I2C bus or the ramp math.
+ *
+ * Each channel has a single writer (main loop stages and I2C on core 0,
+ * STEP on core 1), so counters need no locking; the 64-bit sums may
+ * tear when read across cores, which is acceptable for diagnostics.
+ */
+
+/**
+ * @brief Instrumented code paths
+ */
+enum class StatChannel : uint8_t {
+    LOOP,           // Full main-loop iteration
+    INPUT,          // Protocol::processInput()
+    UPDATE,         // StateMachine::update()
+    DRAIN,          // Protocol::drainData()
+    I2C,            // One NAU7802 sample fetch transaction
+    STEP,           // Step interval jitter (actual vs commanded)
+    CHANNEL_COUNT
+};
+
+/**
+ * @brief Accumulated figures for one channel
+ */
+struct ChannelStats {
+    uint32_t count;                     // Samples recorded
+    uint32_t maxUs;                     // High-water mark (us)
+    uint64_t sumUs;                     // Total us (mean = sumUs / count)
+    uint32_t hist[STATS_HIST_BUCKETS];  // hist[b] counts 2^b <= us < 2^(b+1)
+};
+
+/**
+ * @brief Record one timing sample - ISR-safe, integer-only
+ * @param channel Instrumented path
+ * @param us Measured delta in microseconds
+ */
+void statsRecord(StatChannel channel, uint32_t us);
+
+/**
+ * @brief Get the accumulated figures for a channel
+ * @param channel Instrumented path
+ * @return Accumulated counters
+ */
+const ChannelStats& statsGet(StatChannel channel);
+
+/**
+ * @brief Get the display name of a channel
+ * @param channel Instrumented path
+ * @return Short upper-case name
+ */
+const char* statsChannelName(StatChannel channel);
+
+/**
+ * @brief Zero all channels (STATS RESET)
+ */
+void statsReset(void);
+
+#endif // STATS_H
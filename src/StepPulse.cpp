@@ -0,0 +1,84 @@
+#include "StepPulse.h"
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "step_pulse.pio.h"
+
+// All step generation lives on pio0; pio1 stays free for future use
+#define STEP_PULSE_PIO  pio0
+
+StepPulse::StepPulse(uint8_t stepPin)
+    : _stepPin(stepPin)
+    , _initialized(false)
+    , _sm(-1)
+    , _dmaChannel(-1)
+    , _burstInterval(0)
+{
+}
+
+bool StepPulse::begin() {
+    if (_initialized) return true;
+
+    _sm = pio_claim_unused_sm(STEP_PULSE_PIO, false);
+    if (_sm < 0) {
+        return false;
+    }
+
+    uint offset = pio_add_program(STEP_PULSE_PIO, &step_pulse_program);
+    step_pulse_program_init(STEP_PULSE_PIO, (uint)_sm, offset, _stepPin);
+
+    // DMA channel for constant-interval bursts
+    _dmaChannel = dma_claim_unused_channel(false);
+    if (_dmaChannel >= 0) {
+        dma_channel_config cfg = dma_channel_get_default_config(_dmaChannel);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+        channel_config_set_read_increment(&cfg, false);   // Re-read one interval word
+        channel_config_set_write_increment(&cfg, false);
+        channel_config_set_dreq(&cfg, pio_get_dreq(STEP_PULSE_PIO, (uint)_sm, true));
+        dma_channel_configure(_dmaChannel, &cfg,
+                              &STEP_PULSE_PIO->txf[_sm],  // Write: PIO TX FIFO
+                              &_burstInterval,            // Read: interval word
+                              0,                          // Count set per burst
+                              false);
+    }
+
+    _initialized = true;
+    return true;
+}
+
+bool StepPulse::pulse(uint32_t lowTimeUs) {
+    if (!_initialized) return false;
+    if (pio_sm_is_tx_fifo_full(STEP_PULSE_PIO, (uint)_sm)) {
+        return false;
+    }
+    pio_sm_put(STEP_PULSE_PIO, (uint)_sm, lowTimeUs);
+    return true;
+}
+
+bool StepPulse::queueBurst(uint32_t lowTimeUs, uint32_t count) {
+    if (!_initialized || _dmaChannel < 0 || count == 0) return false;
+    if (isBusy()) return false;
+
+    _burstInterval = lowTimeUs;
+    dma_channel_set_read_addr(_dmaChannel, &_burstInterval, false);
+    dma_channel_set_trans_count(_dmaChannel, count, true);
+    return true;
+}
+
+bool StepPulse::isBusy() const {
+    if (_dmaChannel < 0) return false;
+    return dma_channel_is_busy(_dmaChannel);
+}
+
+void StepPulse::flush() {
+    if (!_initialized) return;
+    while (isBusy()) {
+        tight_loop_contents();
+    }
+    while (!pio_sm_is_tx_fifo_empty(STEP_PULSE_PIO, (uint)_sm)) {
+        tight_loop_contents();
+    }
+    // Last interval is still draining inside the state machine
+    sleep_us(STEP_PULSE_WIDTH_US + STEP_PULSE_INTERVAL_US);
+}
@@ -0,0 +1,80 @@
+#ifndef STEPPULSE_H
+#define STEPPULSE_H
+
+#include <stdint.h>
+#include "Config.h"
+
+/**
+ * @brief PIO-backed STEP pulse generator with DMA-fed interval queue
+ *
+ * Moves STEP pulse shaping off the CPU and onto a PIO state machine.
+ * The state machine runs at 1 MHz and emits a hardware-exact
+ * STEP_PULSE_WIDTH_US pulse for every interval word written to its TX
+ * FIFO, where the word is the low time (us) following the pulse. The
+ * CPU no longer busy-waits in sleep_us() per step - a single FIFO write
+ * (a few cycles) replaces the former gpio_put/sleep_us/gpio_put
+ * sequence in Stepper::step().
+ *
+ * For constant-speed runs (homing approach, backoff) a DMA channel can
+ * feed a whole burst of precomputed intervals into the FIFO with zero
+ * CPU involvement; queueBurst() starts the transfer and isBusy() polls
+ * for completion.
+ */
+class StepPulse {
+public:
+    /**
+     * @brief Construct a new StepPulse object
+     * @param stepPin GPIO pin for STEP output
+     */
+    StepPulse(uint8_t stepPin);
+
+    /**
+     * @brief Claim a PIO state machine and load the pulse program
+     * @return true if a PIO state machine was claimed
+     */
+    bool begin();
+
+    /**
+     * @brief Emit one STEP pulse followed by the given low time
+     *
+     * Non-blocking: drops the pulse if the TX FIFO is full (the caller
+     * paces pulses, so a full FIFO means it is issuing faster than the
+     * driver allows).
+     *
+     * @param lowTimeUs Low time after the pulse in microseconds
+     * @return true if the pulse was queued
+     */
+    bool pulse(uint32_t lowTimeUs = STEP_PULSE_INTERVAL_US);
+
+    /**
+     * @brief Queue a burst of constant-interval pulses via DMA
+     *
+     * The DMA channel re-reads a single interval word, so bursts of any
+     * length cost no RAM and no CPU time while they run.
+     *
+     * @param lowTimeUs Low time between pulses in microseconds
+     * @param count Number of pulses to emit
+     * @return true if the burst was started
+     */
+    bool queueBurst(uint32_t lowTimeUs, uint32_t count);
+
+    /**
+     * @brief Check if a DMA burst is still in progress
+     * @return true if busy
+     */
+    bool isBusy() const;
+
+    /**
+     * @brief Wait for the TX FIFO and any DMA burst to drain
+     */
+    void flush();
+
+private:
+    uint8_t _stepPin;
+    bool _initialized;
+    int _sm;            // Claimed PIO state machine index
+    int _dmaChannel;    // Claimed DMA channel for bursts
+    uint32_t _burstInterval;  // Interval word the burst DMA re-reads
+};
+
+#endif // STEPPULSE_H
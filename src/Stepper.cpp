@@ -1,7 +1,14 @@
 #include "Stepper.h"
+#include "GpioIrq.h"
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
 #include "hardware/timer.h"
+#include "hardware/structs/sio.h"
+#include "Stats.h"
+#include <math.h>
+
+// Instance pointer for the limit switch ISR - one stepper per machine
+static Stepper* s_stepper = nullptr;
 
 Stepper::Stepper(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin)
     : _stepPin(stepPin)
@@ -14,40 +21,72 @@ Stepper::Stepper(uint8_t stepPin, uint8_t dirPin, uint8_t enablePin)
     , _speed(0.0f)
     , _maxSpeed(STEPPER_MAX_SPEED)
     , _acceleration(STEPPER_ACCELERATION)
+    , _jerk(STEPPER_JERK)
     , _stepInterval(0)
     , _lastStepTime(0)
     , _enabled(false)
     , _homed(false)
     , _hasLimitSwitches(false)
     , _direction(Direction::UP)
+    , _topLimitActive(false)
+    , _bottomLimitActive(false)
+    , _topLimitEdgeUs(0)
+    , _bottomLimitEdgeUs(0)
+    , _stepPulse(stepPin)
+    , _dirMask(0)
+    , _dirChangeUs(0)
+    , _rampLength(0)
+    , _rampIndex(0)
+    , _alarmPool(nullptr)
+    , _alarmActive(false)
+    , _lastAlarmUs(0)
+    , _servoActive(false)
+    , _servoSpeed(0.0f)
+    , _servoInterval(0.0f)
+    , _homePhase(HomePhase::INACTIVE)
+    , _homeDir(Direction::DOWN)
+    , _homeSavedMaxSpeed(0.0f)
+    , _homeStartMs(0)
 {
     // Calculate steps per mm based on config
     float stepsPerRev = STEPPER_STEPS_PER_REV * STEPPER_MICROSTEPPING;
     _stepsPerMm = stepsPerRev / STEPPER_MM_PER_REV;
+
+    buildRampTable();
 }
 
 void Stepper::begin() {
-    gpio_init(_stepPin);
     gpio_init(_dirPin);
     gpio_init(_enablePin);
-    
-    gpio_set_dir(_stepPin, GPIO_OUT);
+
     gpio_set_dir(_dirPin, GPIO_OUT);
     gpio_set_dir(_enablePin, GPIO_OUT);
-    
-    gpio_put(_stepPin, false);
-    gpio_put(_dirPin, false);
+
+    // Drive DIR to match the constructed direction so setDirection()'s
+    // unchanged-direction early-out is valid from the first step
+    _dirMask = 1u << _dirPin;
+    gpio_put(_dirPin, _direction == Direction::UP);
     gpio_put(_enablePin, true);  // Disabled by default (active LOW for DM542T)
-    
+
+    // STEP pin is driven by the PIO pulse generator, not software GPIO
+    _stepPulse.begin();
+
     _enabled = false;
     _currentPos = 0;
     _targetPos = 0;
 }
 
+void Stepper::setAlarmPool(struct alarm_pool* pool) {
+    _alarmPool = pool;
+}
+
 void Stepper::enable() {
     gpio_put(_enablePin, false);  // DM542T: LOW = enabled
     _enabled = true;
     sleep_ms(10);  // Allow driver to wake up
+
+    // Resume any move that was commanded while disabled
+    armStepTimer();
 }
 
 void Stepper::disable() {
@@ -66,12 +105,91 @@ void Stepper::setMaxSpeed(float speed) {
         if (_speed > _maxSpeed) {
             _speed = _maxSpeed;
         }
+        buildRampTable();
     }
 }
 
 void Stepper::setAcceleration(float acceleration) {
     if (acceleration < 0.0f) acceleration = -acceleration;
-    _acceleration = acceleration;
+    if (acceleration != _acceleration) {
+        _acceleration = acceleration;
+        buildRampTable();
+    }
+}
+
+void Stepper::setJerk(float jerk) {
+    if (jerk < 1.0f) jerk = 1.0f;
+    if (jerk != _jerk) {
+        _jerk = jerk;
+        buildRampTable();
+    }
+}
+
+void Stepper::buildRampTable() {
+    if (_maxSpeed < 1.0f || _acceleration < 1.0f) {
+        _rampTable[0] = 65535;
+        _rampLength = 1;
+        _rampIndex = 0;
+        return;
+    }
+
+    // Jerk-limited S-curve, integrated per step at build time.
+    // Acceleration ramps at _jerk up to _acceleration and back down as
+    // the speed approaches max, so there is no acceleration step to
+    // ring the load frame. The table keeps the same contract as the old
+    // AVR446 trapezoid: entry n is the interval at ramp position n and
+    // the mirrored replay is a valid deceleration, so computeNewSpeed()
+    // stays an index walk and the stopping distance from position n is
+    // still exactly n steps.
+    float cMin = 1000000.0f / _maxSpeed;
+
+    // Opening interval from standstill: jerk-bound (1 = J*t^3/6) or
+    // acceleration-bound (1 = a*t^2/2), whichever is slower
+    float v = 0.0f;     // steps/s at the current entry
+    float a = 0.0f;     // steps/s^2, jerk-limited
+    float c = cbrtf(6.0f / _jerk);              // seconds
+    float cAccel = sqrtf(2.0f / _acceleration);
+    if (c < cAccel) c = cAccel;
+
+    uint32_t n = 0;
+    while (n < STEPPER_RAMP_TABLE_SIZE) {
+        float cUs = c * 1000000.0f;
+        if (cUs <= cMin || v >= _maxSpeed) {
+            _rampTable[n++] = (uint16_t)cMin;
+            break;  // Cruise interval reached - ramp is complete
+        }
+        if (cUs > 65535.0f) cUs = 65535.0f;
+        _rampTable[n++] = (uint16_t)cUs;
+
+        // Ramp the acceleration out when the remaining speed headroom
+        // equals the distance-in-velocity of unwinding it (a^2/2J),
+        // otherwise ramp it in toward the configured limit
+        float aNext;
+        if (_maxSpeed - v <= (a * a) / (2.0f * _jerk)) {
+            aNext = a - _jerk * c;
+            if (aNext < 0.0f) aNext = 0.0f;
+        } else {
+            aNext = a + _jerk * c;
+            if (aNext > _acceleration) aNext = _acceleration;
+        }
+
+        // Advance one step with the trapezoidal mean acceleration, then
+        // solve 1 = v*c + a*c^2/2 for the next whole-step time
+        v += 0.5f * (a + aNext) * c;
+        if (v > _maxSpeed) v = _maxSpeed;
+        a = aNext;
+
+        if (a > 1.0f) {
+            c = (sqrtf(v * v + 2.0f * a) - v) / a;
+        } else if (v > 0.0f) {
+            c = 1.0f / v;
+        }
+    }
+
+    _rampLength = n;
+    if (_rampIndex >= _rampLength) {
+        _rampIndex = _rampLength - 1;
+    }
 }
 
 void Stepper::setSpeedMmPerSec(float mmPerSec) {
@@ -79,7 +197,9 @@ void Stepper::setSpeedMmPerSec(float mmPerSec) {
 }
 
 void Stepper::moveTo(int32_t position) {
+    _servoActive = false;   // A position move cancels any velocity servo
     _targetPos = position;
+    armStepTimer();
 }
 
 void Stepper::moveToMm(float positionMm) {
@@ -96,33 +216,108 @@ void Stepper::moveMm(float distanceMm) {
 
 bool Stepper::run() {
     if (!_enabled) return false;
-    
+
+    // Stepping happens in the alarm callback. Re-arm here if a move is
+    // pending without an active alarm (e.g. moveTo() was issued while
+    // the driver was disabled).
+    if (!_alarmActive && distanceToGo() != 0) {
+        armStepTimer();
+    }
+
+    return isMoving();
+}
+
+void Stepper::armStepTimer() {
+    if (_alarmActive || !_enabled) return;
+    if (distanceToGo() == 0) return;
+
+    _alarmActive = true;
+    _lastAlarmUs = 0;   // First tick has no previous interval to compare
+    addStepAlarm(_rampTable[_rampIndex]);
+}
+
+void Stepper::addStepAlarm(uint32_t intervalUs) {
+    // The default pool services callbacks on core 0's timer IRQ; the
+    // pool PulseEngine installs keeps them on core 1 with the command
+    // handling and ramp rebuilds (and out of core 0's IRQs-off windows
+    // during flash programming)
+    if (_alarmPool) {
+        alarm_pool_add_alarm_in_us(_alarmPool, intervalUs,
+                                   stepTimerCallback, this, true);
+    } else {
+        add_alarm_in_us(intervalUs, stepTimerCallback, this, true);
+    }
+}
+
+int64_t Stepper::stepTimerCallback(int32_t id, void* userData) {
+    (void)id;
+    return static_cast<Stepper*>(userData)->onStepTimer();
+}
+
+int64_t Stepper::onStepTimer() {
+    // Step-interval jitter: actual callback spacing vs the interval the
+    // previous tick asked for. Integer-only, single writer (core 1).
+    uint32_t nowUs = time_us_32();
+    if (_lastAlarmUs != 0 && _stepInterval > 0.0f) {
+        int32_t jitter = (int32_t)(nowUs - _lastAlarmUs) - (int32_t)_stepInterval;
+        statsRecord(StatChannel::STEP, jitter >= 0 ? jitter : -jitter);
+    }
+    _lastAlarmUs = nowUs;
+
+    if (!_enabled) {
+        _alarmActive = false;
+        return 0;
+    }
+
+    // Velocity-servo mode: constant-interval stepping at the commanded
+    // speed, no ramp walk and no target - the control loop owns speed
+    if (_servoActive) {
+        bool up = _servoSpeed > 0.0f;
+        if (_hasLimitSwitches &&
+            ((up && isAtTopLimit()) || (!up && isAtBottomLimit()))) {
+            _alarmActive = false;
+            return 0;
+        }
+
+        setDirection(up ? Direction::UP : Direction::DOWN);
+        while ((uint32_t)(time_us_32() - _dirChangeUs) < DIR_SETUP_TIME_US) {
+            tight_loop_contents();
+        }
+        _currentPos += up ? 1 : -1;
+        _stepPulse.pulse(STEP_PULSE_INTERVAL_US);
+
+        _stepInterval = _servoInterval;
+        return -(int64_t)_stepInterval;
+    }
+
     int32_t distance = distanceToGo();
-    if (distance == 0) return false;
-    
+    if (distance == 0 && _rampIndex == 0) {
+        _alarmActive = false;
+        _speed = 0;
+        _stepInterval = 0;
+        return 0;
+    }
+
     // Check limit switches
     if (_hasLimitSwitches) {
         if (distance > 0 && isAtTopLimit()) {
             _targetPos = _currentPos;
-            return false;
+            _alarmActive = false;
+            return 0;
         }
         if (distance < 0 && isAtBottomLimit()) {
             _targetPos = _currentPos;
-            return false;
+            _alarmActive = false;
+            return 0;
         }
     }
-    
+
     computeNewSpeed();
-    
-    if (_stepInterval <= 0) return true;
-    
-    uint64_t now = time_us_64();
-    if ((now - _lastStepTime) >= (uint64_t)_stepInterval) {
-        step();
-        _lastStepTime = now;
-    }
-    
-    return true;
+    step();
+
+    // Negative return = schedule relative to the previous deadline, so
+    // callback latency never accumulates into speed error
+    return -(int64_t)_stepInterval;
 }
 
 bool Stepper::runSpeed() {
@@ -148,14 +343,56 @@ bool Stepper::runSpeed() {
     return false;
 }
 
+void Stepper::setServoSpeed(float stepsPerSec) {
+    float mag = stepsPerSec >= 0.0f ? stepsPerSec : -stepsPerSec;
+
+    // Below 1 step/s the interval overflows any sensible alarm period -
+    // treat it as a stop command
+    if (mag < 1.0f) {
+        if (_servoActive) {
+            _servoActive = false;
+            _targetPos = _currentPos;
+            _speed = 0;
+        }
+        return;
+    }
+    if (mag > _maxSpeed) {
+        mag = _maxSpeed;
+    }
+
+    _servoSpeed = stepsPerSec >= 0.0f ? mag : -mag;
+    _servoInterval = 1000000.0f / mag;
+    _speed = _servoSpeed;
+    _servoActive = true;
+
+    // Kick the alarm if stepping is not already scheduled
+    if (!_alarmActive && _enabled) {
+        _alarmActive = true;
+        _lastAlarmUs = 0;
+        addStepAlarm((uint32_t)_servoInterval);
+    }
+}
+
+void Stepper::setServoSpeedMmPerSec(float mmPerSec) {
+    setServoSpeed(mmPerSec * _stepsPerMm);
+}
+
 void Stepper::stop() {
+    _servoActive = false;
     _targetPos = _currentPos;
     _speed = 0;
+    _rampIndex = 0;
 }
 
 void Stepper::stopSmooth() {
-    // Set target so we decelerate to stop
-    int32_t stepsToStop = (int32_t)((_speed * _speed) / (2.0f * _acceleration));
+    // Servo mode has no ramp position to unwind - the control loop
+    // already commands gentle speeds, stop outright
+    if (_servoActive) {
+        stop();
+        return;
+    }
+    // Stopping distance from the current ramp position is its index
+    int32_t stepsToStop = (int32_t)_rampIndex;
     if (_speed > 0) {
         _targetPos = _currentPos + stepsToStop;
     } else {
@@ -164,7 +401,7 @@ void Stepper::stopSmooth() {
 }
 
 bool Stepper::isMoving() const {
-    return _currentPos != _targetPos;
+    return _servoActive || _currentPos != _targetPos;
 }
 
 int32_t Stepper::getCurrentPosition() const {
@@ -187,6 +424,7 @@ void Stepper::setCurrentPosition(int32_t position) {
     _currentPos = position;
     _targetPos = position;
     _speed = 0;
+    _rampIndex = 0;
 }
 
 void Stepper::resetPosition() {
@@ -194,10 +432,22 @@ void Stepper::resetPosition() {
 }
 
 void Stepper::setDirection(Direction dir) {
+    // Called on every step - the unchanged-direction early-out keeps
+    // the per-step cost to a compare
+    if (dir == _direction) {
+        return;
+    }
     _direction = dir;
-    gpio_put(_dirPin, (dir == Direction::UP) ? true : false);
-    // DM542T requires 5µs direction setup time
-    sleep_us(DIR_SETUP_TIME_US);
+
+    // Single SIO set/clear write, mask precomputed in begin(). The 5us
+    // DM542T setup time becomes a deadline stamped here and checked in
+    // step() - no unconditional sleep_us on the hot path.
+    if (dir == Direction::UP) {
+        sio_hw->gpio_set = _dirMask;
+    } else {
+        sio_hw->gpio_clr = _dirMask;
+    }
+    _dirChangeUs = time_us_32();
 }
 
 Direction Stepper::getDirection() const {
@@ -215,66 +465,184 @@ int32_t Stepper::mmToSteps(float mm) const {
 void Stepper::setLimitSwitches(uint8_t topPin, uint8_t bottomPin) {
     _topLimitPin = topPin;
     _bottomLimitPin = bottomPin;
-    
+
     gpio_init(_topLimitPin);
     gpio_init(_bottomLimitPin);
     gpio_set_dir(_topLimitPin, GPIO_IN);
     gpio_set_dir(_bottomLimitPin, GPIO_IN);
     gpio_pull_up(_topLimitPin);
     gpio_pull_up(_bottomLimitPin);
-    
+
+    // Seed the cached flags from the current levels, then let the edge
+    // ISR maintain them - no gpio_get on the per-step path after this
+    _topLimitActive = (gpio_get(_topLimitPin) == false);        // Active LOW
+    _bottomLimitActive = (gpio_get(_bottomLimitPin) == false);
+
+    s_stepper = this;
+    gpioIrqRegister(_topLimitPin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
+                    limitIrqHandler);
+    gpioIrqRegister(_bottomLimitPin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
+                    limitIrqHandler);
+
     _hasLimitSwitches = true;
 }
 
+void Stepper::limitIrqHandler(uint gpio, uint32_t events) {
+    (void)events;
+    Stepper* self = s_stepper;
+    if (self == nullptr) return;
+
+    bool active = (gpio_get(gpio) == false);    // Active LOW
+    uint32_t now = time_us_32();
+
+    if (gpio == self->_topLimitPin) {
+        // Debounce deactivation only: activation always latches
+        if (!active && (now - self->_topLimitEdgeUs) < LIMIT_DEBOUNCE_US) {
+            return;
+        }
+        self->_topLimitEdgeUs = now;
+        self->_topLimitActive = active;
+        if (active && self->_targetPos > self->_currentPos) {
+            // Hard stop: collapse the target AND the ramp, otherwise
+            // the alarm keeps replaying the wound-up deceleration into
+            // the switch for up to _rampIndex more pulses
+            self->_targetPos = self->_currentPos;
+            self->_rampIndex = 0;
+        }
+    } else if (gpio == self->_bottomLimitPin) {
+        if (!active && (now - self->_bottomLimitEdgeUs) < LIMIT_DEBOUNCE_US) {
+            return;
+        }
+        self->_bottomLimitEdgeUs = now;
+        self->_bottomLimitActive = active;
+        if (active && self->_targetPos < self->_currentPos) {
+            self->_targetPos = self->_currentPos;
+            self->_rampIndex = 0;
+        }
+    }
+}
+
 bool Stepper::isAtTopLimit() const {
     if (!_hasLimitSwitches) return false;
-    return gpio_get(_topLimitPin) == false;  // Active LOW
+    return _topLimitActive;     // Maintained by the edge ISR
 }
 
 bool Stepper::isAtBottomLimit() const {
     if (!_hasLimitSwitches) return false;
-    return gpio_get(_bottomLimitPin) == false;  // Active LOW
+    return _bottomLimitActive;
 }
 
-bool Stepper::home(Direction dir) {
+bool Stepper::startHome(Direction dir) {
     if (!_hasLimitSwitches) return false;
+    if (_homePhase != HomePhase::INACTIVE &&
+        _homePhase != HomePhase::DONE &&
+        _homePhase != HomePhase::FAILED) {
+        return false;   // Already homing
+    }
     if (!_enabled) enable();
-    
-    setDirection(dir);
-    _speed = _maxSpeed * 0.5f;  // Home at half speed
-    
-    uint32_t timeout = 60000;  // 60 second timeout
-    uint32_t startTime = to_ms_since_boot(get_absolute_time());
-    
-    // Move until limit switch hit
-    while ((to_ms_since_boot(get_absolute_time()) - startTime) < timeout) {
-        if (dir == Direction::DOWN && isAtBottomLimit()) break;
-        if (dir == Direction::UP && isAtTopLimit()) break;
-        
-        runSpeed();
-        tight_loop_contents();
+
+    _homeDir = dir;
+    _homeSavedMaxSpeed = _maxSpeed;
+    _homeStartMs = to_ms_since_boot(get_absolute_time());
+    _homed = false;
+
+    // Fast approach: ramp toward the switch at near max speed. The
+    // limit ISR collapses the target the instant the switch trips.
+    setMaxSpeed(_homeSavedMaxSpeed * HOMING_FAST_FRACTION);
+    moveTo((dir == Direction::DOWN) ? INT32_MIN / 2 : INT32_MAX / 2);
+
+    _homePhase = HomePhase::FAST_APPROACH;
+    return true;
+}
+
+bool Stepper::homeLimitActive() const {
+    return (_homeDir == Direction::DOWN) ? isAtBottomLimit() : isAtTopLimit();
+}
+
+void Stepper::finishHome(bool success) {
+    stop();
+    setMaxSpeed(_homeSavedMaxSpeed);
+    if (success) {
+        resetPosition();
+        _homed = true;
+        _homePhase = HomePhase::DONE;
+    } else {
+        _homePhase = HomePhase::FAILED;
     }
-    
-    if ((to_ms_since_boot(get_absolute_time()) - startTime) >= timeout) {
-        return false;  // Timeout
+}
+
+bool Stepper::updateHome() {
+    if (_homePhase == HomePhase::INACTIVE ||
+        _homePhase == HomePhase::DONE ||
+        _homePhase == HomePhase::FAILED) {
+        return false;
     }
-    
-    // Back off slightly
-    setDirection((dir == Direction::DOWN) ? Direction::UP : Direction::DOWN);
-    _speed = _maxSpeed * 0.1f;  // Slow speed
-    
-    int32_t backoffSteps = mmToSteps(2.0f);  // 2mm backoff
-    for (int32_t i = 0; i < backoffSteps; i++) {
-        runSpeed();
-        uint64_t interval = (uint64_t)(1000000.0f / _speed);
-        sleep_us(interval);
+
+    if ((to_ms_since_boot(get_absolute_time()) - _homeStartMs) >= HOMING_TIMEOUT_MS) {
+        finishHome(false);
+        return false;
     }
-    
-    // Set position
-    resetPosition();
-    _homed = true;
-    
-    return true;
+
+    int32_t backoffSteps = mmToSteps(HOMING_BACKOFF_MM);
+    int32_t awaySteps = (_homeDir == Direction::DOWN) ? backoffSteps : -backoffSteps;
+
+    switch (_homePhase) {
+        case HomePhase::FAST_APPROACH:
+            if (homeLimitActive()) {
+                // Switch found - back off to release it before the
+                // precision pass
+                stop();
+                move(awaySteps);
+                _homePhase = HomePhase::BACKOFF;
+            } else if (!isMoving()) {
+                // Stopped without a switch: aborted or no switch found
+                finishHome(false);
+            }
+            break;
+
+        case HomePhase::BACKOFF:
+            if (!isMoving()) {
+                // Re-touch slowly - approach speed dominates the
+                // repeatability of the reference position
+                setMaxSpeed(_homeSavedMaxSpeed * HOMING_SLOW_FRACTION);
+                moveTo((_homeDir == Direction::DOWN) ? INT32_MIN / 2
+                                                     : INT32_MAX / 2);
+                _homePhase = HomePhase::SLOW_TOUCH;
+            }
+            break;
+
+        case HomePhase::SLOW_TOUCH:
+            if (homeLimitActive()) {
+                stop();
+                move(awaySteps);
+                _homePhase = HomePhase::FINAL_BACKOFF;
+            } else if (!isMoving()) {
+                finishHome(false);
+            }
+            break;
+
+        case HomePhase::FINAL_BACKOFF:
+            if (!isMoving()) {
+                finishHome(true);   // Zero is HOMING_BACKOFF_MM off the switch
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return isHoming();
+}
+
+bool Stepper::isHoming() const {
+    return _homePhase == HomePhase::FAST_APPROACH ||
+           _homePhase == HomePhase::BACKOFF ||
+           _homePhase == HomePhase::SLOW_TOUCH ||
+           _homePhase == HomePhase::FINAL_BACKOFF;
+}
+
+bool Stepper::homeSucceeded() const {
+    return _homePhase == HomePhase::DONE;
 }
 
 bool Stepper::isHomed() const {
@@ -283,7 +651,13 @@ bool Stepper::isHomed() const {
 
 void Stepper::step() {
     int32_t distance = distanceToGo();
-    
+
+    // Target collapsed mid-tick (limit ISR): no pulse - a pulse here
+    // would drive the motor without moving the software position
+    if (distance == 0) {
+        return;
+    }
+
     if (distance > 0) {
         setDirection(Direction::UP);
         _currentPos++;
@@ -292,55 +666,45 @@ void Stepper::step() {
         _currentPos--;
     }
     
-    // Generate step pulse - DM542T requires minimum 2.5µs pulse width
-    gpio_put(_stepPin, true);
-    sleep_us(STEP_PULSE_WIDTH_US);
-    gpio_put(_stepPin, false);
+    // DIR setup deadline: only the first pulse after a reversal can
+    // land inside the 5us window - step intervals are hundreds of us,
+    // so for every other step this compare passes immediately
+    while ((uint32_t)(time_us_32() - _dirChangeUs) < DIR_SETUP_TIME_US) {
+        tight_loop_contents();
+    }
+
+    // Queue one hardware-timed pulse on the PIO - the state machine
+    // holds STEP high for exactly STEP_PULSE_WIDTH_US, so no sleep_us
+    // busy-wait and no timing skew when an interrupt lands mid-pulse
+    _stepPulse.pulse(STEP_PULSE_INTERVAL_US);
 }
 
 void Stepper::computeNewSpeed() {
     int32_t distance = distanceToGo();
-    
-    if (distance == 0) {
+
+    if (distance == 0 && _rampIndex == 0) {
         _speed = 0;
         _stepInterval = 0;
         return;
     }
-    
-    // Calculate required speed based on distance and acceleration
-    float targetSpeed = (distance > 0) ? _maxSpeed : -_maxSpeed;
-    
-    // Calculate deceleration distance
-    float stepsToStop = (_speed * _speed) / (2.0f * _acceleration);
-    
+
     int32_t absDistance = distance > 0 ? distance : -distance;
-    
-    // Need to decelerate?
-    if ((float)absDistance <= stepsToStop) {
-        // Decelerate
-        if (_speed > 0) {
-            _speed -= _acceleration * (_stepInterval / 1000000.0f);
-            if (_speed < 100) _speed = 100;  // Minimum speed
-        } else {
-            _speed += _acceleration * (_stepInterval / 1000000.0f);
-            if (_speed > -100) _speed = -100;
-        }
-    } else {
-        // Accelerate towards max speed
-        if (_speed < targetSpeed) {
-            _speed += _acceleration * (_stepInterval / 1000000.0f);
-            if (_speed > targetSpeed) _speed = targetSpeed;
-        } else if (_speed > targetSpeed) {
-            _speed -= _acceleration * (_stepInterval / 1000000.0f);
-            if (_speed < targetSpeed) _speed = targetSpeed;
-        }
-    }
-    
-    // Calculate step interval in microseconds
-    float absSpeed = _speed > 0 ? _speed : -_speed;
-    if (absSpeed > 0) {
-        _stepInterval = 1000000.0f / absSpeed;
-    } else {
-        _stepInterval = 0;
+
+    // Moving against the commanded direction? Ramp down to zero first.
+    bool reversing = (distance > 0 && _speed < 0) || (distance < 0 && _speed > 0);
+
+    // The deceleration ramp mirrors the acceleration ramp, so the
+    // stopping distance from ramp position n is exactly n steps -
+    // no v^2/2a float math per step, just index compares
+    if (reversing || (uint32_t)absDistance <= _rampIndex) {
+        if (_rampIndex > 0) _rampIndex--;   // Decelerate
+    } else if (_rampIndex + 1 < _rampLength) {
+        _rampIndex++;                        // Accelerate
     }
+
+    _stepInterval = _rampTable[_rampIndex];
+
+    // Keep _speed coherent for runSpeed()/stopSmooth() observers
+    float speed = 1000000.0f / _stepInterval;
+    _speed = (distance >= 0) ? speed : -speed;
 }
@@ -3,6 +3,10 @@
 
 #include <stdint.h>
 #include "Config.h"
+#include "StepPulse.h"
+#include "GpioIrq.h"    // uint + GPIO event types for the limit ISR
+
+struct alarm_pool;      // pico/time.h - step alarms fire on core 1's pool
 
 /**
  * @brief Movement direction enumeration
@@ -12,6 +16,19 @@ enum class Direction : uint8_t {
     DOWN = 1    // Release direction (downward movement)
 };
 
+/**
+ * @brief Phases of the two-phase homing sequence
+ */
+enum class HomePhase : uint8_t {
+    INACTIVE = 0,
+    FAST_APPROACH,  // Near-max-speed run toward the limit switch
+    BACKOFF,        // Back off to release the switch
+    SLOW_TOUCH,     // Precision re-touch at a fraction of max speed
+    FINAL_BACKOFF,  // Retreat to the zero position
+    DONE,
+    FAILED
+};
+
 /**
  * @brief Stepper motor controller class
  * 
@@ -33,6 +50,19 @@ public:
      */
     void begin();
 
+    /**
+     * @brief Route step alarms through a specific alarm pool
+     *
+     * The default pool services its callbacks on core 0's timer IRQ,
+     * which would put stepping back under core-0 IRQs-off windows
+     * (flash programming) and race the ramp rebuilds running on
+     * core 1. PulseEngine passes a pool it creates on core 1, so
+     * callbacks, command handling and table rebuilds share one core.
+     *
+     * @param pool Alarm pool to arm step timers on (nullptr = default)
+     */
+    void setAlarmPool(struct alarm_pool* pool);
+
     /**
      * @brief Enable the stepper motor driver
      */
@@ -61,6 +91,12 @@ public:
      */
     void setAcceleration(float acceleration);
 
+    /**
+     * @brief Set the jerk limit for the S-curve ramp
+     * @param jerk Jerk in steps per second cubed
+     */
+    void setJerk(float jerk);
+
     /**
      * @brief Set speed in mm/s
      * @param mmPerSec Speed in millimeters per second
@@ -92,7 +128,15 @@ public:
     void moveMm(float distanceMm);
 
     /**
-     * @brief Run the motor - call frequently for motion
+     * @brief Service the motor
+     *
+     * Stepping is scheduled on a hardware alarm: moveTo()/move() arm a
+     * timer whose callback issues each step and re-arms at the next
+     * ramp interval, so step timing is independent of how often this is
+     * called. run() only re-arms the timer if it found nothing to do
+     * when the move was commanded (e.g. driver was disabled) and
+     * reports whether motion is still in progress.
+     *
      * @return true if motor is still moving
      */
     bool run();
@@ -103,6 +147,26 @@ public:
      */
     bool runSpeed();
 
+    /**
+     * @brief Run at a commanded velocity (closed-loop servo mode)
+     *
+     * Engages continuous stepping at the given signed speed with no
+     * target position - the caller's control loop owns the velocity.
+     * Changing speed is a couple of stores (no ramp-table rebuild), so
+     * it can be called at the full sample rate. Speed magnitudes below
+     * 1 step/s disengage servo mode and halt. Limit switches are still
+     * honoured per step.
+     *
+     * @param stepsPerSec Signed speed (positive = up), clamped to max
+     */
+    void setServoSpeed(float stepsPerSec);
+
+    /**
+     * @brief Servo-mode velocity command in mm/s
+     * @param mmPerSec Signed speed (positive = up)
+     */
+    void setServoSpeedMmPerSec(float mmPerSec);
+
     /**
      * @brief Stop motor immediately
      */
@@ -156,6 +220,13 @@ public:
 
     /**
      * @brief Set movement direction for continuous movement
+     *
+     * Early-outs when the direction is unchanged, so the per-step cost
+     * is one compare. An actual flip is a single SIO set/clear write
+     * with the precomputed pin mask; the DM542T's 5us direction setup
+     * time is enforced as a deadline in step() rather than a sleep
+     * here, so only the first pulse after a reversal can ever wait.
+     *
      * @param dir Movement direction
      */
     void setDirection(Direction dir);
@@ -200,11 +271,35 @@ public:
     bool isAtBottomLimit() const;
 
     /**
-     * @brief Home the motor (move to limit switch)
+     * @brief Start the two-phase homing sequence
+     *
+     * Fast approach toward the limit switch at HOMING_FAST_FRACTION of
+     * max speed, back off HOMING_BACKOFF_MM, re-touch slowly for a
+     * repeatable reference, then retreat to the zero position. Runs as
+     * non-blocking states - call updateHome() to advance.
+     *
      * @param dir Direction to home
-     * @return true if homing successful
+     * @return true if the sequence started
+     */
+    bool startHome(Direction dir = Direction::DOWN);
+
+    /**
+     * @brief Advance the homing sequence - call every loop iteration
+     * @return true while homing is still in progress
+     */
+    bool updateHome();
+
+    /**
+     * @brief Check if a homing sequence is in progress
+     * @return true while homing
+     */
+    bool isHoming() const;
+
+    /**
+     * @brief Check if the last homing sequence succeeded
+     * @return true if homed to the switch
      */
-    bool home(Direction dir = Direction::DOWN);
+    bool homeSucceeded() const;
 
     /**
      * @brief Check if motor has been homed
@@ -219,11 +314,15 @@ private:
     uint8_t _topLimitPin;
     uint8_t _bottomLimitPin;
     
-    int32_t _currentPos;
-    int32_t _targetPos;
+    // Position counters are read from core 0 while the core-1 pulse
+    // engine steps the motor; single aligned 32-bit accesses are atomic
+    // on the RP2040, volatile keeps the cross-core reads honest.
+    volatile int32_t _currentPos;
+    volatile int32_t _targetPos;
     float _speed;
     float _maxSpeed;
     float _acceleration;
+    float _jerk;
     float _stepInterval;
     uint32_t _lastStepTime;
     
@@ -232,8 +331,87 @@ private:
     bool _hasLimitSwitches;
     Direction _direction;
 
+    // Limit switch state, maintained by the GPIO edge ISR so the
+    // per-step path reads a cached flag instead of gpio_get(). Edges
+    // inside LIMIT_DEBOUNCE_US of the previous one are ignored, except
+    // that an activating edge always latches - a bouncing contact must
+    // never delay a stop.
+    volatile bool _topLimitActive;
+    volatile bool _bottomLimitActive;
+    volatile uint32_t _topLimitEdgeUs;      // Last accepted edge time
+    volatile uint32_t _bottomLimitEdgeUs;
+
+    StepPulse _stepPulse;   // PIO pulse generator for the STEP pin
+
+    // Direction pin fast path: mask precomputed once in begin() for
+    // direct SIO set/clear writes, flip timestamp for the DIR setup
+    // deadline check in step()
+    uint32_t _dirMask;
+    uint32_t _dirChangeUs;
+
     float _stepsPerMm;  // Calculated from config
 
+    // Precomputed jerk-limited (S-curve) ramp, tabulated per step.
+    // Entry n is the step interval in us at ramp position n; built
+    // once when speed, acceleration or jerk changes, so the per-step
+    // work in computeNewSpeed() is a table index and a compare instead
+    // of float math on every step.
+    uint16_t _rampTable[STEPPER_RAMP_TABLE_SIZE];
+    uint32_t _rampLength;   // Valid entries in the table
+    uint32_t _rampIndex;    // Current position on the ramp
+
+    // Hardware-alarm step scheduling
+    struct alarm_pool* _alarmPool;  // Core-1 pool (nullptr = default pool)
+    volatile bool _alarmActive;     // Step alarm currently armed
+    uint32_t _lastAlarmUs;          // Last callback entry, for jitter stats
+
+    // Velocity-servo mode: continuous stepping at a commanded speed,
+    // no target position, no ramp table - the external control loop
+    // (HOLD_FORCE / strain rate) supplies the velocity profile
+    volatile bool _servoActive;
+    float _servoSpeed;              // Signed steps/s
+    float _servoInterval;           // us between steps at _servoSpeed
+
+    // Two-phase homing state
+    HomePhase _homePhase;
+    Direction _homeDir;
+    float _homeSavedMaxSpeed;       // Restored when homing ends
+    uint32_t _homeStartMs;          // For the overall timeout
+
+    /**
+     * @brief Arm the step alarm if motion is pending
+     */
+    void armStepTimer();
+
+    /**
+     * @brief Schedule the step alarm on the configured pool
+     * @param intervalUs Microseconds until the first callback
+     */
+    void addStepAlarm(uint32_t intervalUs);
+
+    /**
+     * @brief Alarm callback body - steps and returns the next interval
+     * @return Microseconds to next step (negative = from last deadline),
+     *         0 to stop rescheduling
+     */
+    int64_t onStepTimer();
+
+    /**
+     * @brief Static alarm trampoline
+     */
+    static int64_t stepTimerCallback(int32_t id, void* userData);
+
+    /**
+     * @brief GPIO ISR for the limit switch pins
+     *
+     * Updates the cached limit flags and, when a limit activates while
+     * motion is heading into it, collapses the target onto the current
+     * position and zeroes the ramp index - a hard stop, so stepping
+     * ends at the next alarm tick instead of replaying the wound-up
+     * deceleration into the switch.
+     */
+    static void limitIrqHandler(uint gpio, uint32_t events);
+
     /**
      * @brief Perform a single step
      */
@@ -243,6 +421,25 @@ private:
      * @brief Compute new speed with acceleration
      */
     void computeNewSpeed();
+
+    /**
+     * @brief Rebuild the S-curve ramp table
+     *
+     * Called whenever max speed, acceleration or jerk changes.
+     */
+    void buildRampTable();
+
+    /**
+     * @brief Check if the limit switch in the homing direction is hit
+     * @return true if the homing-direction limit is active
+     */
+    bool homeLimitActive() const;
+
+    /**
+     * @brief Finish homing - restore speed and record the outcome
+     * @param success true if the switch was found
+     */
+    void finishHome(bool success);
 };
 
 #endif // STEPPER_H
@@ -14,6 +14,8 @@
  * 
  * Serial Commands:
  * - START     : Start tensile test
+ * - HOLD x    : Start closed-loop force hold at x N (creep)
+ * - STRAINRATE x : Start constant-true-strain-rate test at x 1/s
  * - STOP      : Stop current test
  * - PAUSE     : Pause test
  * - RESUME    : Resume paused test
@@ -25,11 +27,21 @@
  * - SPEED x   : Set test speed (mm/s)
  * - MAXFORCE x: Set max force limit (N)
  * - MAXEXT x  : Set max extension limit (mm)
+ * - EVDELTA/EVSLOPE/EVDROP/EVGAP x : Adaptive-sampling thresholds
  * - TARE      : Tare load cell
+ * - SAVE      : Persist calibration and test parameters to flash
+ * - AREA x    : Set specimen cross-section (mm^2)
+ * - GAUGE x   : Set specimen gauge length (mm)
+ * - ANALYSIS  : Get live modulus/energy readout
  * - STATUS    : Get current status
+ * - STATS     : Get hot-path timing statistics
  * - FORCE     : Get current force
  * - POS       : Get current position
  * - CONFIG    : Get configuration
+ * - BINMODE [0|1|2] : DATA framing (0=ASCII, 1=binary, 2=delta)
+ * - HISPEED [n]   : 320 SPS acquisition, boxcar length n (0=off)
+ * - DUAL [0|1]    : Interleave the NAU7802's second input channel
+ * - DUMP      : Replay flash-captured test data
  * - ID        : Get device identification
  * - RESET     : Reset system
  */
@@ -43,8 +55,13 @@
 #include "Config.h"
 #include "LoadCell.h"
 #include "Stepper.h"
+#include "PulseEngine.h"
 #include "Protocol.h"
+#include "Capture.h"
+#include "Settings.h"
 #include "StateMachine.h"
+#include "Stats.h"
+#include "Scheduler.h"
 
 // ============================================================================
 // Global Objects
@@ -53,83 +70,183 @@
 // Hardware interfaces
 LoadCell loadCell(NAU7802_SDA_PIN, NAU7802_SCL_PIN);
 Stepper stepper(STEPPER_STEP_PIN, STEPPER_DIR_PIN, STEPPER_ENABLE_PIN);
+PulseEngine pulseEngine(stepper);
 Protocol protocol;
+Capture capture;
+Settings settings;
 
 // State machine
-StateMachine stateMachine(loadCell, stepper, protocol);
+StateMachine stateMachine(loadCell, stepper, pulseEngine, protocol, capture, settings);
+
+// Startup bookkeeping - the banner waits for USB in the background
+static bool loadCellOk = false;
+static bool settingsOk = false;
+static bool bannerPending = true;
+
+// ============================================================================
+// Scheduler Tasks
+// ============================================================================
+// The main loop is a cooperative scheduler: each stage below is a task
+// with a period and a time budget. Overruns and lateness show up in the
+// STATS TASK lines; the stage timers keep feeding the histograms as
+// before. None of these may block - tare, homing and flash capture are
+// all asynchronous - which is what finally lets the watchdog stay on.
+
+static void printBanner();
+
+/**
+ * @brief Process serial commands (every pass)
+ *
+ * A scripted host bursts whole parameter sets (SPEED, MAXFORCE, START)
+ * in one USB buffer - handle up to COMMAND_BATCH queued commands per
+ * pass so turnaround is one loop, bounded to protect the task budget.
+ */
+static void taskInput() {
+    uint32_t t0 = time_us_32();
+    for (int i = 0; i < COMMAND_BATCH; i++) {
+        Command cmd = protocol.processInput();
+        if (cmd == Command::NONE) {
+            break;
+        }
+        stateMachine.handleCommand(cmd);
+    }
+    statsRecord(StatChannel::INPUT, time_us_32() - t0);
+}
+
+/**
+ * @brief Run the state machine - safety checks, control law, sampling
+ *
+ * Every pass: this is the safety path, and its worst-case start latency
+ * is bounded by the budgets of the other tasks in the table.
+ */
+static void taskUpdate() {
+    uint32_t t0 = time_us_32();
+    stateMachine.update();
+    statsRecord(StatChannel::UPDATE, time_us_32() - t0);
+}
+
+/**
+ * @brief Drain queued test data and the TX ring to USB (1ms period)
+ */
+static void taskDrain() {
+    uint32_t t0 = time_us_32();
+    protocol.drainData();
+    statsRecord(StatChannel::DRAIN, time_us_32() - t0);
+}
+
+/**
+ * @brief Emit the startup banner once USB has enumerated (100ms period)
+ */
+static void taskBanner() {
+    if (bannerPending && stdio_usb_connected()) {
+        bannerPending = false;
+        printBanner();
+    }
+}
 
 // ============================================================================
 // Setup
 // ============================================================================
 
 void setup() {
-    // Initialize Pico stdio (USB CDC)
+    // Initialize Pico stdio (USB CDC) - do NOT wait for enumeration.
+    // The machine accepts commands as soon as the host connects; the
+    // banner is printed from loop() once USB is actually up.
     stdio_init_all();
-    
-    // Wait for USB connection (with timeout)
-    for (int i = 0; i < 30 && !stdio_usb_connected(); i++) {
-        sleep_ms(100);
+
+    // Load persisted calibration/config - a validated read from
+    // memory-mapped flash, microseconds, before any peripheral comes up
+    settingsOk = settings.load();
+    bool restoreAfe = settingsOk && settings.data().afeValid;
+
+    // Initialize load cell (NAU7802). begin() only configures
+    // registers (~10ms); with a saved AFE calibration the internal
+    // calibration cycle is skipped entirely and the registers are
+    // restored below, otherwise calibration and the startup tare
+    // finish asynchronously as readForce() runs.
+    loadCellOk = loadCell.begin(!restoreAfe);
+    if (loadCellOk) {
+        if (settingsOk) {
+            const SettingsBlock& s = settings.data();
+            loadCell.setCalibrationFactor(s.calibrationFactor);
+            loadCell.setOffset(s.offset);
+            loadCell.setSecondaryCalibrationFactor(s.calibrationFactor2);
+            loadCell.setSecondaryOffset(s.offset2);
+            if (restoreAfe) {
+                loadCell.restoreAfeCalibration(s.afeOcal, s.afeGcal);
+            }
+        }
+        // Switch to interrupt-driven acquisition - readForce() no
+        // longer polls the bus waiting for conversions
+        loadCell.enableDataReadyInterrupt(NAU7802_DRDY_PIN);
     }
-    
-    sleep_ms(500);  // Additional delay for terminal to connect
-    
-    // Startup message
+
+    // Initialize stepper motor
+    stepper.begin();
+    stepper.setLimitSwitches(LIMIT_SWITCH_TOP_PIN, LIMIT_SWITCH_BOTTOM_PIN);
+    stepper.setMaxSpeed(STEPPER_MAX_SPEED);
+    stepper.setAcceleration(STEPPER_ACCELERATION);
+
+    // Launch pulse engine on core 1 - all stepping runs there from now on
+    pulseEngine.begin();
+
+    // Initialize state machine and protocol
+    stateMachine.begin();
+    protocol.begin(SERIAL_BAUD_RATE);
+
+    // Register the main-loop tasks. Budgets are generous multiples of
+    // the measured worst cases, so an overrun means something real -
+    // a SAVE-triggered flash erase will show up, a healthy pass never
+    schedulerAddTask("INPUT",  taskInput,  0,      1000);
+    schedulerAddTask("UPDATE", taskUpdate, 0,      1000);
+    schedulerAddTask("DRAIN",  taskDrain,  1000,   1000);
+    schedulerAddTask("BANNER", taskBanner, 100000, 5000);
+
+    // Arm the deadlines and enable the watchdog - safe now that no
+    // task blocks; a wedged I2C bus resets the machine instead of
+    // freezing it with the motor energized
+    schedulerBegin();
+}
+
+/**
+ * @brief Print the startup banner once the host is listening
+ */
+static void printBanner() {
     printf("\n");
     printf("========================================\n");
     printf("  DIY Tensile Tester - Pico Firmware\n");
     printf("  Version 2.0.0\n");
     printf("========================================\n");
     printf("\n");
-    
-    // Initialize load cell (NAU7802)
-    printf("Initializing NAU7802 ADC... ");
-    if (loadCell.begin()) {
-        printf("OK (Rev: 0x%02X)\n", loadCell.getRevision());
+
+    if (loadCellOk) {
+        printf("NAU7802 ADC: OK (Rev: 0x%02X)\n", loadCell.getRevision());
     } else {
-        printf("FAILED!\n");
-        printf("Check I2C wiring: SDA=GP%d, SCL=GP%d\n", NAU7802_SDA_PIN, NAU7802_SCL_PIN);
+        printf("NAU7802 ADC: FAILED!\n");
+        printf("Check I2C wiring: SDA=GP%d, SCL=GP%d\n",
+               NAU7802_SDA_PIN, NAU7802_SCL_PIN);
     }
-    
-    // Initialize stepper motor
-    printf("Initializing stepper driver (DM542T)... ");
-    stepper.begin();
-    stepper.setLimitSwitches(LIMIT_SWITCH_TOP_PIN, LIMIT_SWITCH_BOTTOM_PIN);
-    stepper.setMaxSpeed(STEPPER_MAX_SPEED);
-    stepper.setAcceleration(STEPPER_ACCELERATION);
-    printf("OK\n");
-    
-    // Initialize state machine
-    printf("Initializing state machine... ");
-    stateMachine.begin();
-    printf("OK\n");
-    
-    // Print configuration
+
+    printf("Config: %s\n", settingsOk ? "restored from flash" : "defaults");
+
     printf("\n");
     printf("Configuration:\n");
     printf("  Load Cell: 500N S-type (NAU7802)\n");
-    printf("  Stepper: %d steps/rev, 1/%d microstepping\n", 
+    printf("  Stepper: %d steps/rev, 1/%d microstepping\n",
            STEPPER_STEPS_PER_REV, STEPPER_MICROSTEPPING);
     printf("  Lead Screw: %.1f mm/rev\n", STEPPER_MM_PER_REV);
     printf("  Max Force: %.0f N\n", LOADCELL_MAX_FORCE);
     printf("  Sample Rate: %d ms\n", SAMPLE_RATE_MS);
-    
-    // Check limit switches
+
     printf("\n");
     printf("Limit switches: TOP=%s BOTTOM=%s\n",
            stepper.isAtTopLimit() ? "ACTIVE" : "open",
            stepper.isAtBottomLimit() ? "ACTIVE" : "open");
-    
-    // Ready message
+
     printf("\n");
     printf("System ready. Type 'ID' for identification.\n");
     printf("Type 'HOME' to home the machine before testing.\n");
     printf("\n");
-    
-    // Initialize protocol (after USB is ready)
-    protocol.begin(SERIAL_BAUD_RATE);
-    
-    // Enable watchdog
-    // watchdog_enable(WATCHDOG_TIMEOUT_MS, true);
 }
 
 // ============================================================================
@@ -137,17 +254,11 @@ void setup() {
 // ============================================================================
 
 void loop() {
-    // Process serial commands
-    Command cmd = protocol.processInput();
-    if (cmd != Command::NONE) {
-        stateMachine.handleCommand(cmd);
-    }
-    
-    // Update state machine
-    stateMachine.update();
-    
-    // Feed watchdog
-    // watchdog_update();
+    // One scheduler pass: feed the watchdog, run the due tasks with
+    // deadline accounting. The LOOP channel still times the whole pass
+    uint32_t t0 = time_us_32();
+    schedulerRun();
+    statsRecord(StatChannel::LOOP, time_us_32() - t0);
 }
 
 // ============================================================================